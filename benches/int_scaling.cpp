@@ -0,0 +1,269 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../sources/pyincpp.hpp"
+
+using pyincpp::Int;
+
+namespace
+{
+
+// Sweep the operand size from 1 chunk to 10^6 chunks (9 decimal digits per chunk), multiplying by 4 each step.
+constexpr int MIN_CHUNKS = 1;
+constexpr int MAX_CHUNKS = 1'000'000;
+
+// Keep measuring one size for at least this long to get a stable ns/op.
+constexpr double MIN_TIME_NS = 20e6;
+
+// Stop growing the size of an operation once a single call takes longer than this.
+constexpr double MAX_CALL_NS = 2e9;
+
+struct Sample
+{
+    int chunks;
+    double ns_per_op;
+};
+
+struct Result
+{
+    std::string op;
+    std::vector<Sample> samples;
+    double exponent; // fitted k of O(n^k)
+};
+
+// Keep the results of measured calls from being optimized away.
+volatile bool sink;
+
+// Operation to benchmark, prepared for operands of `chunks` chunks. Return the measured call.
+using Setup = std::function<std::function<void()>(int chunks)>;
+
+// Return a random positive integer with `chunks` chunks.
+Int random_chunks(int chunks)
+{
+    return Int::random(chunks * 9);
+}
+
+// Measure the average time of one call in nanoseconds.
+double measure(const std::function<void()>& call)
+{
+    using clock = std::chrono::steady_clock;
+
+    long long iterations = 0;
+    double elapsed = 0;
+    auto start = clock::now();
+    do
+    {
+        call();
+        ++iterations;
+        elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    } while (elapsed < MIN_TIME_NS && elapsed < MAX_CALL_NS);
+
+    return elapsed / iterations;
+}
+
+// Least squares slope of log(ns) against log(chunks), ignoring tiny sizes dominated by constant overhead.
+double fit_exponent(const std::vector<Sample>& samples)
+{
+    std::vector<Sample> points;
+    for (const auto& s : samples)
+    {
+        if (s.chunks >= 16)
+        {
+            points.push_back(s);
+        }
+    }
+    if (points.size() < 2)
+    {
+        points = samples;
+    }
+    if (points.size() < 2)
+    {
+        return 0;
+    }
+
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const auto& p : points)
+    {
+        double x = std::log(p.chunks), y = std::log(p.ns_per_op);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double n = points.size();
+    return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+Result sweep(const std::string& op, const Setup& setup)
+{
+    Result result{op, {}, 0};
+    for (long long chunks = MIN_CHUNKS; chunks <= MAX_CHUNKS; chunks *= 4)
+    {
+        auto call = setup(chunks);
+        double ns = measure(call);
+        result.samples.push_back({int(chunks), ns});
+        if (ns > MAX_CALL_NS)
+        {
+            break;
+        }
+    }
+    result.exponent = fit_exponent(result.samples);
+    return result;
+}
+
+// Output format from the environment variable `PYINCPP_BENCH_FORMAT`: "table" (default), "csv" or "json".
+void report(const std::vector<Result>& results)
+{
+    const char* env = std::getenv("PYINCPP_BENCH_FORMAT");
+    std::string_view format = env ? env : "table";
+
+    if (format == "csv")
+    {
+        std::cout << "op,chunks,ns_per_op,exponent\n";
+        for (const auto& r : results)
+        {
+            for (const auto& s : r.samples)
+            {
+                std::cout << r.op << ',' << s.chunks << ',' << std::fixed << std::setprecision(1) << s.ns_per_op << ',' << std::setprecision(3) << r.exponent << '\n';
+            }
+        }
+    }
+    else if (format == "json")
+    {
+        std::cout << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            std::cout << "  {\"op\": \"" << r.op << "\", \"exponent\": " << std::fixed << std::setprecision(3) << r.exponent << ", \"samples\": [";
+            for (std::size_t j = 0; j < r.samples.size(); ++j)
+            {
+                std::cout << (j ? ", " : "") << "{\"chunks\": " << r.samples[j].chunks << ", \"ns_per_op\": " << std::setprecision(1) << r.samples[j].ns_per_op << "}";
+            }
+            std::cout << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        std::cout << "]\n";
+    }
+    else
+    {
+        for (const auto& r : results)
+        {
+            std::cout << r.op << "  ~ O(n^" << std::fixed << std::setprecision(2) << r.exponent << ")\n";
+            for (const auto& s : r.samples)
+            {
+                std::cout << "  " << std::setw(8) << s.chunks << " chunks " << std::setw(18) << std::setprecision(1) << s.ns_per_op << " ns/op\n";
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("pyincpp::Int scaling", "[.scaling]")
+{
+    std::vector<Result> results;
+
+    results.push_back(sweep("+", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n), b = random_chunks(n)]
+                                {
+                                    sink = (a + b).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("-", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n) * 2, b = random_chunks(n)]
+                                {
+                                    sink = (a - b).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("*", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n), b = random_chunks(n)]
+                                {
+                                    sink = (a * b).is_zero();
+                                };
+                            }));
+
+    // dividend of 2n chunks, divisor of n chunks
+    results.push_back(sweep("/", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(2 * n), b = random_chunks(n)]
+                                {
+                                    sink = (a / b).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("%", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(2 * n), b = random_chunks(n)]
+                                {
+                                    sink = (a % b).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("sqrt", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n)]
+                                {
+                                    sink = Int::sqrt(a).is_zero();
+                                };
+                            }));
+
+    // base and modulus of n chunks, fixed exponent of one chunk
+    results.push_back(sweep("pow-mod", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n), m = random_chunks(n)]
+                                {
+                                    sink = Int::pow(a, 999999937, m).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("gcd", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n), b = random_chunks(n)]
+                                {
+                                    sink = Int::gcd(a, b).is_zero();
+                                };
+                            }));
+
+    results.push_back(sweep("to_string", [](int n) -> std::function<void()>
+                            {
+                                return [a = random_chunks(n)]
+                                {
+                                    sink = a.to_string().empty();
+                                };
+                            }));
+
+    results.push_back(sweep("parse", [](int n) -> std::function<void()>
+                            {
+                                return [s = random_chunks(n).to_string()]
+                                {
+                                    sink = Int(s.c_str()).is_zero();
+                                };
+                            }));
+
+    report(results);
+}
+
+/*
+The sweep is hidden from a plain `xmake run bench` because it takes minutes.
+Run with: `xmake config -m release && xmake build bench && xmake run bench [scaling]`
+
+Machine-readable output for regression tracking:
+`PYINCPP_BENCH_FORMAT=csv xmake run bench [scaling]` or `PYINCPP_BENCH_FORMAT=json xmake run bench [scaling]`
+
+Each operation is swept from 1 to 10^6 chunks, multiplying by 4 each step,
+and stops early once a single call takes more than 2 seconds.
+The exponent k is a least squares fit of log(ns/op) against log(chunks) for sizes >= 16 chunks.
+*/
@@ -7,16 +7,26 @@
 #define DETAIL_HPP
 
 #include <algorithm>     // std::copy std::find std::rotate ...
+#include <array>         // std::array
+#include <atomic>        // std::atomic
+#include <bit>           // std::has_single_bit std::countr_zero std::countr_one std::bit_width std::popcount
 #include <cassert>       // assert
+#include <charconv>      // std::to_chars std::from_chars
 #include <climits>       // INT_MAX
 #include <cmath>         // std::abs std::pow std::sqrt ...
-#include <concepts>      // std::integral
-#include <cstring>       // std::strlen
+#include <concepts>      // std::integral std::floating_point
+#include <condition_variable> // std::condition_variable
+#include <cstdint>       // std::uint32_t std::uint64_t
+#include <cstring>       // std::strlen std::memchr std::memcmp
+#include <deque>         // std::deque
+#include <exception>     // std::exception_ptr std::current_exception std::rethrow_exception
 #include <functional>    // std::less
 #include <iomanip>       // std::setw std::setfill
 #include <istream>       // std::istream
 #include <iterator>      // std::input_iterator
 #include <limits>        // std::numeric_limits
+#include <memory>        // std::shared_ptr std::make_shared
+#include <mutex>         // std::mutex std::lock_guard
 #include <numeric>       // std::gcd
 #include <optional>      // std::optional
 #include <ostream>       // std::ostream
@@ -27,11 +37,28 @@
 #include <stdexcept>     // std::runtime_error
 #include <string>        // std::string std::getline
 #include <string_view>   // std::string_view
+#include <system_error>  // std::errc
+#include <thread>        // std::thread
 #include <type_traits>   // std::is_same_v
+#include <unordered_map> // std::unordered_map
 #include <unordered_set> // std::unordered_set
 #include <utility>       // std::initializer_list std::move
 #include <vector>        // std::vector
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h> // _mm256_cmpeq_epi8 _mm_cmpeq_epi8 ...
+#endif
+
+// SIMD kernels are templates over the instruction set (detail::Sse2 or detail::Avx2) that are always inlined,
+// so the AVX2 instantiation takes the target of an entry point marked PYINCPP_AVX2, which is only called if detail::has_avx2().
+#if defined(__GNUC__)
+#define PYINCPP_AVX2 __attribute__((target("avx2")))
+#define PYINCPP_KERNEL __attribute__((always_inline))
+#else
+#define PYINCPP_AVX2
+#define PYINCPP_KERNEL
+#endif
+
 namespace pyincpp::detail
 {
 
@@ -126,6 +153,282 @@ static inline T gcd(T a, T b)
     return a; // a is the GCD
 }
 
+// Persistent worker threads shared by parallel algorithms, created on demand and reused across calls.
+class WorkerPool
+{
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+
+    WorkerPool() = default;
+
+    // Run queued tasks until the pool is stopped.
+    void work()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                ready_.wait(lock, [this]()
+                            { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty()) // stopped
+                {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task(); // never throws, see run()
+        }
+    }
+
+public:
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_all();
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    // The pool of the process.
+    static WorkerPool& instance()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    // Call task(0), ..., task(n - 1) in parallel, task(0) on the calling thread.
+    // Return after all of them finish, then rethrow the exception of the first task that threw, if any.
+    template <typename F>
+    void run(int n, const F& task)
+    {
+        std::vector<std::exception_ptr> errors(n);
+        std::mutex done_mutex;
+        std::condition_variable done;
+        int queued = 0, finished = 0;
+
+        try
+        {
+            std::lock_guard lock(mutex_);
+            while (int(workers_.size()) < n - 1)
+            {
+                workers_.emplace_back(&WorkerPool::work, this);
+            }
+            for (int t = 1; t < n; ++t, ++queued)
+            {
+                tasks_.emplace_back([&, t]()
+                                    {
+                                        try
+                                        {
+                                            task(t);
+                                        }
+                                        catch (...)
+                                        {
+                                            errors[t] = std::current_exception();
+                                        }
+                                        std::lock_guard done_lock(done_mutex);
+                                        ++finished;
+                                        done.notify_one();
+                                    });
+            }
+        }
+        catch (...) // failed to start a thread or queue a task, the queued ones still run
+        {
+            errors[0] = std::current_exception();
+        }
+        ready_.notify_all();
+
+        if (!errors[0])
+        {
+            try
+            {
+                task(0);
+            }
+            catch (...)
+            {
+                errors[0] = std::current_exception();
+            }
+        }
+
+        std::unique_lock lock(done_mutex);
+        done.wait(lock, [&]()
+                  { return finished == queued; });
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+// Whether the CPU supports AVX2, detected once at runtime. SSE2 is always available on x86-64.
+static inline bool has_avx2()
+{
+#if defined(__GNUC__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#elif defined(__AVX2__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Byte-wise operations on 16 characters at a time with SSE2.
+struct Sse2
+{
+    using vec = __m128i;
+
+    static constexpr int WIDTH = sizeof(vec);
+    static constexpr unsigned ALL = (1u << WIDTH) - 1;
+
+    static vec set1(char c)
+    {
+        return _mm_set1_epi8(c);
+    }
+
+    static vec load(const char* p)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const vec*>(p));
+    }
+
+    static void store(char* p, vec v)
+    {
+        _mm_storeu_si128(reinterpret_cast<vec*>(p), v);
+    }
+
+    static vec eq(vec a, vec b)
+    {
+        return _mm_cmpeq_epi8(a, b);
+    }
+
+    static vec below(vec v, vec limit)
+    {
+        return _mm_cmpeq_epi8(_mm_min_epu8(v, limit), v); // v <= limit, unsigned
+    }
+
+    static vec add(vec a, vec b)
+    {
+        return _mm_add_epi8(a, b);
+    }
+
+    static vec sub(vec a, vec b)
+    {
+        return _mm_sub_epi8(a, b);
+    }
+
+    static vec bit_and(vec a, vec b)
+    {
+        return _mm_and_si128(a, b);
+    }
+
+    static vec bit_or(vec a, vec b)
+    {
+        return _mm_or_si128(a, b);
+    }
+
+    static vec bit_xor(vec a, vec b)
+    {
+        return _mm_xor_si128(a, b);
+    }
+
+    static vec select(vec mask, vec a, vec b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    static unsigned movemask(vec v)
+    {
+        return unsigned(_mm_movemask_epi8(v));
+    }
+};
+
+// Byte-wise operations on 32 characters at a time with AVX2, only used if has_avx2().
+struct Avx2
+{
+    using vec = __m256i;
+
+    static constexpr int WIDTH = sizeof(vec);
+    static constexpr unsigned ALL = ~0u;
+
+    PYINCPP_AVX2 static vec set1(char c)
+    {
+        return _mm256_set1_epi8(c);
+    }
+
+    PYINCPP_AVX2 static vec load(const char* p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const vec*>(p));
+    }
+
+    PYINCPP_AVX2 static void store(char* p, vec v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<vec*>(p), v);
+    }
+
+    PYINCPP_AVX2 static vec eq(vec a, vec b)
+    {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+
+    PYINCPP_AVX2 static vec below(vec v, vec limit)
+    {
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(v, limit), v); // v <= limit, unsigned
+    }
+
+    PYINCPP_AVX2 static vec add(vec a, vec b)
+    {
+        return _mm256_add_epi8(a, b);
+    }
+
+    PYINCPP_AVX2 static vec sub(vec a, vec b)
+    {
+        return _mm256_sub_epi8(a, b);
+    }
+
+    PYINCPP_AVX2 static vec bit_and(vec a, vec b)
+    {
+        return _mm256_and_si256(a, b);
+    }
+
+    PYINCPP_AVX2 static vec bit_or(vec a, vec b)
+    {
+        return _mm256_or_si256(a, b);
+    }
+
+    PYINCPP_AVX2 static vec bit_xor(vec a, vec b)
+    {
+        return _mm256_xor_si256(a, b);
+    }
+
+    PYINCPP_AVX2 static vec select(vec mask, vec a, vec b)
+    {
+        return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+    }
+
+    PYINCPP_AVX2 static unsigned movemask(vec v)
+    {
+        return unsigned(_mm256_movemask_epi8(v));
+    }
+};
+#endif
+
 } // namespace pyincpp::detail
 
 // Heterogeneous pair comparison.
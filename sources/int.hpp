@@ -11,6 +11,16 @@
 namespace pyincpp
 {
 
+class Int;
+
+inline namespace literals
+{
+
+template <char... Chars>
+Int operator""_i();
+
+} // namespace literals
+
 /// Int provides support for big integer arithmetic.
 class Int
 {
@@ -21,6 +31,95 @@ private:
     // Number of decimal digits per chunk.
     static constexpr int DIGITS_PER_CHUNK = 9; // ceil(log10(base));
 
+    // Copy-on-write list of chunks: copies share one buffer until one of them is modified.
+    // Read access is const, write access goes through `mut()` which detaches a shared buffer.
+    class Chunks
+    {
+    private:
+        // Shared buffer, null if empty.
+        std::shared_ptr<std::vector<int>> data_;
+
+    public:
+        Chunks() = default;
+
+        Chunks(std::vector<int> chunks)
+            : data_(chunks.empty() ? nullptr : std::make_shared<std::vector<int>>(std::move(chunks)))
+        {
+        }
+
+        // Get the buffer for modification, copy it first if it is shared.
+        std::vector<int>& mut()
+        {
+            if (!data_)
+            {
+                data_ = std::make_shared<std::vector<int>>();
+            }
+            else if (data_.use_count() > 1)
+            {
+                data_ = std::make_shared<std::vector<int>>(*data_);
+            }
+            return *data_;
+        }
+
+        std::size_t size() const
+        {
+            return data_ ? data_->size() : 0;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        const int& operator[](std::size_t i) const
+        {
+            return (*data_)[i];
+        }
+
+        const int& back() const
+        {
+            return data_->back();
+        }
+
+        const int* begin() const
+        {
+            return data_ ? data_->data() : nullptr;
+        }
+
+        const int* end() const
+        {
+            return begin() + size();
+        }
+
+        bool operator==(const Chunks& that) const
+        {
+            return data_ == that.data_ || std::equal(begin(), end(), that.begin(), that.end());
+        }
+
+        void push_back(int chunk)
+        {
+            mut().push_back(chunk);
+        }
+
+        void pop_back()
+        {
+            mut().pop_back();
+        }
+
+        // Keep the buffer for reuse if it is not shared.
+        void clear()
+        {
+            if (data_ && data_.use_count() == 1)
+            {
+                data_->clear();
+            }
+            else
+            {
+                data_.reset();
+            }
+        }
+    };
+
     // Sign of integer, 1 is positive, -1 is negative, and 0 is zero.
     signed char sign_;
 
@@ -30,7 +129,7 @@ private:
     // chunk: 456789000 123
     // index: 0         1
     // ```
-    std::vector<int> chunks_;
+    Chunks chunks_;
 
     // Remove leading zeros and correct sign.
     Int& trim()
@@ -48,6 +147,71 @@ private:
         return *this;
     }
 
+    // Value of each character as a digit, case-insensitive, 36 for the characters that are not digits.
+    static constexpr std::array<unsigned char, 256> DIGIT_VALUES = []
+    {
+        std::array<unsigned char, 256> values{};
+        values.fill(36);
+        for (int i = 0; i < 10; ++i)
+        {
+            values['0' + i] = i;
+        }
+        for (int i = 0; i < 26; ++i)
+        {
+            values['a' + i] = values['A' + i] = 10 + i;
+        }
+        return values;
+    }();
+
+#if defined(__SSE2__) || defined(_M_X64)
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi" // the AVX2 kernel is always inlined into a PYINCPP_AVX2 function, so no call crosses the ABI
+#endif
+    // Return the first character in [`first`, `last`) that is not a digit based on `base`, or where less than a vector remains.
+    template <typename S>
+    PYINCPP_KERNEL static const char* digits_end_kernel(const char* first, const char* last, int base)
+    {
+        // compute the digit values of a vector of characters at once: c - '0' if < 10, else (c | 0x20) - 'a' + 10 if < 36, else 0xFF
+        using vec = typename S::vec;
+        const vec zero = S::set1('0'), nine = S::set1(9), a = S::set1('a'), twenty_five = S::set1(25), ten = S::set1(10), lower = S::set1(0x20);
+        const vec none = S::set1(char(0xFF)), max_digit = S::set1(char(base - 1));
+        for (; last - first >= S::WIDTH; first += S::WIDTH)
+        {
+            vec chars = S::load(first);
+            vec decimal = S::sub(chars, zero);
+            vec letter = S::sub(S::bit_or(chars, lower), a);
+            vec value = S::select(S::below(decimal, nine), decimal, S::select(S::below(letter, twenty_five), S::add(letter, ten), none));
+            if (unsigned mask = S::movemask(S::below(value, max_digit)); mask != S::ALL)
+            {
+                return first + std::countr_one(mask);
+            }
+        }
+        return first;
+    }
+
+    PYINCPP_AVX2 static const char* digits_end_avx2(const char* first, const char* last, int base)
+    {
+        return digits_end_kernel<detail::Avx2>(first, last, base);
+    }
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    // Return the end of the run of digits based on `base` at the beginning of [`first`, `last`).
+    static const char* digits_end(const char* first, const char* last, int base)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        first = detail::has_avx2() ? digits_end_avx2(first, last, base) : digits_end_kernel<detail::Sse2>(first, last, base);
+#endif
+        while (first != last && DIGIT_VALUES[static_cast<unsigned char>(*first)] < base)
+        {
+            ++first;
+        }
+        return first;
+    }
+
     // Test whether the characters represent an integer.
     static bool is_integer(const char* chars, int len)
     {
@@ -75,17 +239,18 @@ private:
         assert(sign_ != 0);
 
         // add a leading zero for carry
-        chunks_.push_back(0);
+        auto& chunks = chunks_.mut();
+        chunks.push_back(0);
 
         int i = 0;
-        while (chunks_[i] == BASE - 1)
+        while (chunks[i] == BASE - 1)
         {
             ++i;
         }
-        ++chunks_[i];
+        ++chunks[i];
         while (i != 0)
         {
-            chunks_[--i] = 0;
+            chunks[--i] = 0;
         }
 
         trim(); // sign unchanged
@@ -96,15 +261,16 @@ private:
     {
         assert(sign_ != 0);
 
+        auto& chunks = chunks_.mut();
         int i = 0;
-        while (chunks_[i] == 0)
+        while (chunks[i] == 0)
         {
             ++i;
         }
-        --chunks_[i];
+        --chunks[i];
         while (i != 0)
         {
-            chunks_[--i] = BASE - 1;
+            chunks[--i] = BASE - 1;
         }
 
         trim(); // sign may change to zero
@@ -126,7 +292,7 @@ private:
     }
 
     // Compare absolute value.
-    int abs_cmp(const std::vector<int>& that_chunks) const
+    int abs_cmp(const Chunks& that_chunks) const
     {
         if (chunks_.size() != that_chunks.size())
         {
@@ -144,50 +310,436 @@ private:
         return 0;
     }
 
+    // Compare absolute value with a primitive integer's absolute value.
+    int abs_cmp(unsigned long long n) const
+    {
+        int n_chunks[3]; // ULLONG_MAX < b^3
+        int n_len = 0;
+        for (; n != 0; n /= BASE)
+        {
+            n_chunks[n_len++] = n % BASE;
+        }
+
+        if (int(chunks_.size()) != n_len)
+        {
+            return int(chunks_.size()) > n_len ? 1 : -1;
+        }
+
+        for (int i = n_len - 1; i >= 0; --i)
+        {
+            if (chunks_[i] != n_chunks[i])
+            {
+                return chunks_[i] > n_chunks[i] ? 1 : -1;
+            }
+        }
+
+        return 0;
+    }
+
     // Helper constructor.
-    Int(signed char sign, const std::vector<int>& chunks)
+    Int(signed char sign, Chunks chunks)
         : sign_(sign)
-        , chunks_(chunks)
+        , chunks_(std::move(chunks))
+    {
+    }
+
+    // Upper bound (exclusive) of the small operands, so that `chunk * n + carry` fits in unsigned long long.
+    static constexpr unsigned long long SMALL_MAX = ULLONG_MAX / BASE - 1; // about 1.8e10
+
+    // Minimum number of chunks of each slice for parallel multiplication.
+    static constexpr int PARALLEL_MIN_CHUNKS = 256;
+
+    // Number of threads used by multiplication of the current thread.
+    static inline thread_local int threads_ = 1;
+
+    // Schoolbook multiplication: c[0, na + nb) = a[0, na) * b[0, nb), require c is filled with zeros. O(N*M)
+    static void mul_kernel(const int* a, int na, const int* b, int nb, int* c)
+    {
+        for (int i = 0; i < na; ++i)
+        {
+            for (int j = 0; j < nb; ++j)
+            {
+                long long tmp = 1ll * a[i] * b[j] + c[i + j];
+                c[i + j] = tmp % BASE;      // t%b < b
+                c[i + j + 1] += tmp / BASE; // be modulo by the previous line in the next loop, or finally c + t/b <= 0 + ((b-1)^2 + (b-1))/b = b - 1 < b
+            }
+        }
+    }
+
+    // Split a primitive integer into sign and absolute value, avoid overflow of `std::abs(LLONG_MIN)`.
+    template <std::integral T>
+    static std::pair<int, unsigned long long> sign_abs(T n)
     {
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (n < 0)
+            {
+                return {-1, 0ull - static_cast<unsigned long long>(n)};
+            }
+        }
+        return {n != 0, static_cast<unsigned long long>(n)};
     }
 
-    // Multiply with small int. O(N)
-    void small_mul(int n)
+    // Multiply the absolute value with small int. O(N)
+    void small_mul(unsigned long long n)
     {
-        assert(is_positive());
-        assert(n > 0 && n < BASE);
+        assert(!is_zero());
+        assert(n > 0 && n < SMALL_MAX);
 
-        int carry = 0;
-        for (auto& chunk : chunks_)
+        unsigned long long carry = 0;
+        for (auto& chunk : chunks_.mut())
         {
-            long long tmp = 1ll * chunk * n + carry;
+            unsigned long long tmp = chunk * n + carry;
             chunk = tmp % BASE; // t%b < b
-            carry = tmp / BASE; // t/b <= ((b-1)*(b-1) + (b-1))/b = b - 1 < b
+            carry = tmp / BASE; // t/b < ((b-1)*n + n)/b = n
+        }
+        for (; carry != 0; carry /= BASE) // carry may take more than one chunk
+        {
+            chunks_.push_back(carry % BASE);
         }
-        chunks_.push_back(carry);
 
         trim();
     }
 
-    // Divide with small int. O(N)
+    // Add small int to the absolute value. O(N)
+    void small_add(unsigned long long n)
+    {
+        assert(!is_zero());
+
+        auto& chunks = chunks_.mut();
+        for (int i = 0; n != 0; ++i)
+        {
+            if (i == int(chunks.size()))
+            {
+                chunks.push_back(0);
+            }
+            int tmp = chunks[i] + int(n % BASE); // t <= (b-1) + (b-1) < 2*b < INT_MAX
+            chunks[i] = tmp % BASE;
+            n = n / BASE + tmp / BASE; // carry 1 or 0
+        }
+    }
+
+    // Subtract small int from the absolute value, require abs(this) >= n. O(N)
+    void small_sub(unsigned long long n)
+    {
+        assert(!is_zero());
+        assert(abs_cmp(n) >= 0);
+
+        auto& chunks = chunks_.mut();
+        for (int i = 0; n != 0; ++i)
+        {
+            int tmp = chunks[i] - int(n % BASE);
+            chunks[i] = cycle_mod(tmp, BASE);
+            n = n / BASE - floor_div(tmp, BASE); // borrow 1 or 0
+        }
+
+        trim(); // sign may change to zero
+    }
+
+    // Divide the absolute value with small int. O(N)
     // Return the remainder.
-    int small_div(int n)
+    unsigned long long small_div(unsigned long long n)
     {
-        assert(is_positive());
-        assert(n > 0 && n < BASE);
+        assert(!is_zero());
+        assert(n > 0 && n < SMALL_MAX);
 
-        long long r = 0;
-        for (auto& chunk : chunks_ | std::views::reverse)
+        unsigned long long r = 0;
+        for (auto& chunk : chunks_.mut() | std::views::reverse)
         {
             r = r * BASE + chunk;
             chunk = r / n; // r/n <= ((n-1)*b+(b-1))/n = (n*b - 1)/n < b
-            r %= n;        // r%n < r%b < b
+            r %= n;        // r%n < n
         }
 
         trim();
-        return int(r);
+        return r;
+    }
+
+    // Return the remainder of the absolute value divided by small int, without modifying this. O(N)
+    unsigned long long small_mod(unsigned long long n) const
+    {
+        assert(n > 0 && n < SMALL_MAX);
+
+        unsigned long long r = 0;
+        for (const auto& chunk : chunks_ | std::views::reverse)
+        {
+            r = (r * BASE + chunk) % n;
+        }
+
+        return r;
+    }
+
+    // Convert the absolute value to 32-bit words, little endian. O(N^2) but only multiplications, no divisions.
+    std::vector<std::uint32_t> to_words() const
+    {
+        std::vector<std::uint32_t> words;
+        words.reserve(chunks_.size()); // log(2^32) / log(10^9) < 1.07
+
+        // Horner's method from the most significant chunk: words = words * BASE + chunk
+        for (const auto& chunk : chunks_ | std::views::reverse)
+        {
+            std::uint64_t carry = chunk;
+            for (auto& word : words)
+            {
+                carry += std::uint64_t(word) * BASE; // w*b + c < 2^32 * 2^30 + 2^32 < 2^64
+                word = std::uint32_t(carry);
+                carry >>= 32;
+            }
+            if (carry != 0)
+            {
+                words.push_back(std::uint32_t(carry)); // carry < b < 2^32
+            }
+        }
+
+        return words;
+    }
+
+    // Convert the integer to a string based on 2-36 `base` with a `prefix` after the sign, like `hex()` in Python.
+    std::string to_prefixed_string(int base, std::string_view prefix) const
+    {
+        std::string str = sign_ == -1 ? "-" : "";
+        str += prefix;
+        str += abs().to_string(base); // abs() shares the chunks
+        return str;
+    }
+
+    // Add a primitive integer which is split into `sign` and `abs`.
+    Int& small_add_signed(int sign, unsigned long long abs)
+    {
+        if (sign == 0)
+        {
+            return *this;
+        }
+
+        // if this is zero or the operands are of the same sign, just add the absolute value
+        if (sign_ == 0 || sign_ == sign)
+        {
+            sign_ = sign;
+            small_add(abs);
+            return *this;
+        }
+
+        // now, the operands are of opposite signs
+
+        if (abs_cmp(abs) >= 0)
+        {
+            small_sub(abs);
+            return *this;
+        }
+
+        // abs(this) < abs < 2^64, so the result fits in unsigned long long
+        unsigned long long value = 0;
+        for (const auto& chunk : chunks_ | std::views::reverse)
+        {
+            value = value * BASE + chunk;
+        }
+        chunks_.clear();
+        sign_ = sign;
+        small_add(abs - value);
+        return *this;
+    }
+
+    // Carry-save accumulator for summing many integers.
+    // Chunks are added without carry into a buffer, and normalized only once at the end.
+    class Accumulator
+    {
+    private:
+        // Chunk sums of positive and negative addends.
+        std::vector<unsigned long long> pos_, neg_;
+
+        // Propagate the carries of chunk sums.
+        static Int normalize(const std::vector<unsigned long long>& sums)
+        {
+            Int result(1, {});
+            auto& chunks = result.chunks_.mut();
+            chunks.reserve(sums.size() + 2);
+
+            unsigned long long carry = 0;
+            for (const auto& sum : sums)
+            {
+                carry += sum; // no overflow for less than 1.8e10 addends
+                chunks.push_back(carry % BASE);
+                carry /= BASE;
+            }
+            for (; carry != 0; carry /= BASE)
+            {
+                chunks.push_back(carry % BASE);
+            }
+
+            return result.trim();
+        }
+
+    public:
+        void add(const Int& n)
+        {
+            auto& sums = n.sign_ == 1 ? pos_ : neg_;
+            if (sums.size() < n.chunks_.size())
+            {
+                sums.resize(n.chunks_.size());
+            }
+            for (int i = 0; i < int(n.chunks_.size()); ++i)
+            {
+                sums[i] += n.chunks_[i];
+            }
+        }
+
+        Int result() const
+        {
+            return normalize(pos_) - normalize(neg_);
+        }
+    };
+
+    // Return `n! / (ks[0]! * ks[1]! * ...)`, require `sum(ks) <= n`.
+    // The exponent of each prime p <= n is counted by Legendre's formula, then the prime powers are multiplied by a product tree.
+    // If the largest k is close to n, n! / k! has only a few factors, so they are multiplied directly without sieving up to n.
+    static Int factorial_quotient(int n, const std::vector<int>& ks)
+    {
+        assert(n >= 0);
+
+        auto max_k = std::max_element(ks.begin(), ks.end());
+        if (max_k != ks.end() && 1ll * (n - *max_k) * (n - *max_k) <= n)
+        {
+            Int result = 1;
+            for (long long i = *max_k + 1ll; i <= n; ++i)
+            {
+                result.small_mul(i);
+            }
+            for (auto it = ks.begin(); it != ks.end(); ++it)
+            {
+                if (it == max_k)
+                {
+                    continue;
+                }
+                for (int i = 2; i <= *it; ++i)
+                {
+                    result.small_div(i); // exact, since n! / (max_k! * i!) is an integer
+                }
+            }
+            return result;
+        }
+
+        // sieve of Eratosthenes
+        std::vector<bool> composite(std::size_t(n) + 1);
+        std::vector<unsigned long long> factors;
+        unsigned long long factor = 1;
+        for (long long p = 2; p <= n; ++p)
+        {
+            if (composite[p])
+            {
+                continue;
+            }
+            for (long long m = 1ll * p * p; m <= n; m += p)
+            {
+                composite[m] = true;
+            }
+
+            // exponent of p in n! is n/p + n/p^2 + ...
+            auto legendre = [p](long long m)
+            {
+                long long e = 0;
+                for (; m != 0; m /= p)
+                {
+                    e += m / p;
+                }
+                return e;
+            };
+            long long e = legendre(n);
+            for (const auto& k : ks)
+            {
+                e -= legendre(k);
+            }
+
+            // pack prime powers into 64-bit factors to keep the product tree small
+            for (; e > 0; --e)
+            {
+                if (factor > ULLONG_MAX / p)
+                {
+                    factors.push_back(factor);
+                    factor = 1;
+                }
+                factor *= p;
+            }
+        }
+        factors.push_back(factor);
+
+        return product(factors);
+    }
+
+    // Convert a non-negative integer argument to int for the factorial based functions.
+    static int factorial_arg(const Int& n, const char* message)
+    {
+        if (n.is_negative() || n.abs_cmp(INT_MAX) > 0)
+        {
+            throw std::runtime_error(message);
+        }
+        return n.to_number();
+    }
+
+    // Chunks of an integer literal, parsed at compile time.
+    template <std::size_t N>
+    struct Literal
+    {
+        std::array<int, N> chunks{};
+        std::size_t size = 0;
+    };
+
+    // Parse the characters of an integer literal (decimal, hex, binary or octal, with digit separators) at compile time.
+    template <char... Chars>
+    static consteval auto parse_literal()
+    {
+        constexpr char chars[] = {Chars...};
+        constexpr std::size_t len = sizeof...(Chars);
+
+        int base = 10;
+        std::size_t i = 0;
+        if (len >= 2 && chars[0] == '0' && (chars[1] == 'x' || chars[1] == 'X'))
+        {
+            base = 16, i = 2;
+        }
+        else if (len >= 2 && chars[0] == '0' && (chars[1] == 'b' || chars[1] == 'B'))
+        {
+            base = 2, i = 2;
+        }
+        else if (len >= 2 && chars[0] == '0')
+        {
+            base = 8, i = 1;
+        }
+
+        Literal<len / 4 + 2> result; // a hex digit is less than 1.21 decimal digits, so len / 4 + 2 chunks are enough
+        for (; i < len; ++i)
+        {
+            char c = chars[i];
+            if (c == '\'')
+            {
+                continue;
+            }
+
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : base;
+            if (digit >= base)
+            {
+                throw "Error: Wrong integer literal."; // not a constant expression, so it fails at compile time
+            }
+
+            // result = result * base + digit
+            long long carry = digit;
+            for (std::size_t k = 0; k < result.size; ++k)
+            {
+                carry += 1LL * result.chunks[k] * base;
+                result.chunks[k] = carry % BASE;
+                carry /= BASE;
+            }
+            if (carry != 0)
+            {
+                result.chunks[result.size++] = carry;
+            }
+        }
+
+        return result;
     }
 
+    template <char... Chars>
+    friend Int literals::operator""_i();
+
 public:
     /*
      * Constructor
@@ -198,15 +750,11 @@ public:
     template <std::integral T = int>
     Int(T n = 0)
     {
-        sign_ = n == 0 ? 0 : (n > 0 ? 1 : -1);
-        if constexpr (std::is_signed_v<T>)
+        auto [sign, abs] = sign_abs(n);
+        sign_ = sign;
+        for (; abs > 0; abs /= BASE)
         {
-            n = std::abs(n);
-        }
-        while (n > 0)
-        {
-            chunks_.push_back(n % BASE);
-            n /= BASE;
+            chunks_.push_back(abs % BASE);
         }
     }
 
@@ -219,29 +767,7 @@ public:
             throw std::runtime_error("Error: Wrong integer literal.");
         }
 
-        sign_ = (chars[0] == '-' ? -1 : 1);
-
-        // skip symbol
-        std::string_view digits(chars + (chars[0] == '-' || chars[0] == '+'), chars + len);
-
-        const int chunks_len = std::ceil(double(digits.size()) / DIGITS_PER_CHUNK);
-        chunks_.resize(chunks_len, 0);
-
-        // every DIGITS_PER_CHUNK digits into a chunk (align right)
-        int chunk = 0;
-        int idx = chunks_len;
-        for (int i = 0; i < digits.size(); ++i)
-        {
-            chunk = chunk * 10 + (digits[i] - '0'); // faster than (digits[i] ^ 0x30) in -O2
-            // I think maybe it's not the fastest, but it's the most elegant
-            if ((i + 1) % DIGITS_PER_CHUNK == digits.size() % DIGITS_PER_CHUNK)
-            {
-                chunks_[--idx] = chunk;
-                chunk = 0;
-            }
-        }
-
-        trim();
+        from_chars(chars + (chars[0] == '+'), chars + len, *this); // skip '+', from_chars only accepts '-'
     }
 
     /// Copy constructor.
@@ -284,6 +810,30 @@ public:
                                  : std::partial_ordering::equivalent;
     }
 
+    /// Determine whether this integer is equal to a primitive integer, without constructing a temporary `Int`.
+    template <std::integral T>
+    bool operator==(T that) const
+    {
+        auto [sign, abs] = sign_abs(that);
+        return sign_ == sign && abs_cmp(abs) == 0;
+    }
+
+    /// Compare the integer with a primitive integer, without constructing a temporary `Int`.
+    template <std::integral T>
+    std::partial_ordering operator<=>(T that) const
+    {
+        auto [sign, abs] = sign_abs(that);
+        if (sign_ != sign)
+        {
+            return sign_ <=> sign;
+        }
+
+        int cmp = sign_ * abs_cmp(abs);
+        return cmp < 0   ? std::partial_ordering::less
+               : cmp > 0 ? std::partial_ordering::greater
+                         : std::partial_ordering::equivalent;
+    }
+
     /*
      * Assignment
      */
@@ -317,6 +867,39 @@ public:
         return (chunks_.size() - 1) * DIGITS_PER_CHUNK + std::floor(std::log10(chunks_.back())) + 1;
     }
 
+    /// Return the number of bits necessary to represent the absolute value of the integer, like `int.bit_length()` in Python.
+    long long bit_length() const
+    {
+        if (is_zero())
+        {
+            return 0;
+        }
+
+        auto [mantissa, exp] = frexp();
+
+        // the estimated exponent can only be wrong when the mantissa is within the error of frexp() to a power of two,
+        // the error grows linearly with the number of chunks, so confirm the exponent by comparing with 2^(exp-1) exactly
+        double tolerance = 4.0 * (chunks_.size() + 1) * std::numeric_limits<double>::epsilon();
+        if (double m = std::abs(mantissa); m < 0.5 + tolerance || m > 1 - tolerance)
+        {
+            Int power = pow(2, exp - 1);
+            if (abs_cmp(power.chunks_) < 0)
+            {
+                --exp;
+            }
+            else
+            {
+                power.small_mul(2);
+                if (abs_cmp(power.chunks_) >= 0)
+                {
+                    ++exp;
+                }
+            }
+        }
+
+        return exp;
+    }
+
     /// Determine whether the integer is zero quickly.
     bool is_zero() const
     {
@@ -399,7 +982,7 @@ public:
         // now, the sign of two integers is the same and not zero
 
         // normalize
-        auto& a = chunks_;
+        auto& a = chunks_.mut();
         const auto& b = rhs.chunks_;
         a.resize(std::max(a.size(), b.size()) + 1); // a.len is max+1
 
@@ -437,14 +1020,14 @@ public:
         // now, the sign of two integers is the same and not zero
 
         // normalize
-        std::vector<int> rhs_digits = rhs.chunks_;
+        Chunks rhs_chunks = rhs.chunks_;
         if (abs_cmp(rhs.chunks_) == -1) // let a.len >= b.len
         {
             sign_ = -sign_;
-            chunks_.swap(rhs_digits);
+            std::swap(chunks_, rhs_chunks);
         }
-        auto& a = chunks_;
-        const auto& b = rhs_digits;
+        auto& a = chunks_.mut(); // copied here if shared
+        const auto& b = rhs_chunks;
         a.push_back(0);
 
         // calculate
@@ -475,19 +1058,44 @@ public:
         // now, the sign of two integers is not zero
 
         // normalize
-        const auto& a = chunks_;
-        const auto& b = rhs.chunks_;
+        const auto& a = chunks_.size() >= rhs.chunks_.size() ? chunks_ : rhs.chunks_; // let a.len >= b.len
+        const auto& b = chunks_.size() >= rhs.chunks_.size() ? rhs.chunks_ : chunks_;
         Int result(sign_ == rhs.sign_ ? 1 : -1, std::vector<int>(a.size() + b.size()));
-        auto& c = result.chunks_;
+        auto& c = result.chunks_.mut();
 
-        // calculate
-        for (int i = 0; i < a.size(); ++i)
+        // calculate, split the rows into slices of at least PARALLEL_MIN_CHUNKS for each thread
+        const int threads = std::min<int>(threads_, std::min(a.size(), b.size()) / PARALLEL_MIN_CHUNKS);
+        if (threads <= 1)
         {
-            for (int j = 0; j < b.size(); ++j)
+            mul_kernel(a.begin(), a.size(), b.begin(), b.size(), c.data());
+        }
+        else
+        {
+            // the workers are reused across calls, and an exception in any of them is rethrown here
+            std::vector<std::vector<int>> parts(threads);
+            detail::WorkerPool::instance().run(threads, [&](int t)
+                                               {
+                                                   const int begin = a.size() * t / threads, end = a.size() * (t + 1) / threads;
+                                                   parts[t].resize(end - begin + b.size());
+                                                   mul_kernel(a.begin() + begin, end - begin, b.begin(), b.size(), parts[t].data());
+                                               });
+
+            // c = sum of parts[t] * base^begin
+            std::vector<long long> sums(c.size());
+            for (int t = 0; t < threads; ++t)
             {
-                long long tmp = 1ll * a[i] * b[j] + c[i + j];
-                c[i + j] = tmp % BASE;      // t%b < b
-                c[i + j + 1] += tmp / BASE; // be modulo by the previous line in the next loop, or finally c + t/b <= 0 + ((b-1)^2 + (b-1))/b = b - 1 < b
+                const int begin = a.size() * t / threads;
+                for (int i = 0; i < int(parts[t].size()); ++i)
+                {
+                    sums[begin + i] += parts[t][i]; // < threads * b
+                }
+            }
+            long long carry = 0;
+            for (int i = 0; i < int(c.size()); ++i)
+            {
+                carry += sums[i];
+                c[i] = carry % BASE;
+                carry /= BASE;
             }
         }
 
@@ -527,9 +1135,7 @@ public:
         // if rhs < base, then use small_div in O(N)
         if (rhs.chunks_.size() == 1)
         {
-            Int a = abs();                                   // can't be chained cause q is ref
-            int r = a.small_div(rhs.chunks_[0]);             // this.abs divmod rhs.abs
-            return {sign_ == rhs.sign_ ? a : -a, sign_ * r}; // r.sign = this.sign
+            return divmod(rhs.sign_ * rhs.chunks_[0]);
         }
 
         // dividend, divisor, temporary quotient, accumulated quotient
@@ -558,6 +1164,111 @@ public:
         return {sign_ == rhs.sign_ ? q : -q, sign_ == 1 ? a : -a};
     }
 
+    /// Return this += `rhs` where `rhs` is a primitive integer, without constructing a temporary `Int`.
+    template <std::integral T>
+    Int& operator+=(T rhs)
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        return small_add_signed(sign, abs);
+    }
+
+    /// Return this -= `rhs` where `rhs` is a primitive integer, without constructing a temporary `Int`.
+    template <std::integral T>
+    Int& operator-=(T rhs)
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        return small_add_signed(-sign, abs);
+    }
+
+    /// Return this *= `rhs` where `rhs` is a primitive integer, without constructing a temporary `Int` if abs(rhs) < 1.8e10.
+    template <std::integral T>
+    Int& operator*=(T rhs)
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        if (sign_ == 0 || sign == 0)
+        {
+            return *this = 0;
+        }
+
+        if (abs >= SMALL_MAX)
+        {
+            return *this *= Int(rhs);
+        }
+
+        small_mul(abs);
+        sign_ *= sign;
+        return *this;
+    }
+
+    /// Return this /= `rhs` where `rhs` is a primitive integer, without constructing a temporary `Int` if abs(rhs) < 1.8e10.
+    /// Divide by zero will throw a `runtime_error` exception.
+    template <std::integral T>
+    Int& operator/=(T rhs)
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        detail::check_zero(abs);
+
+        if (abs >= SMALL_MAX)
+        {
+            return *this /= Int(rhs);
+        }
+
+        if (sign_ != 0)
+        {
+            small_div(abs);
+            sign_ *= sign; // still zero if the quotient is zero
+        }
+        return *this;
+    }
+
+    /// Return this %= `rhs` where `rhs` is a primitive integer, without constructing a temporary `Int` if abs(rhs) < 1.8e10.
+    /// Divide by zero will throw a `runtime_error` exception.
+    template <std::integral T>
+    Int& operator%=(T rhs)
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        detail::check_zero(abs);
+
+        if (abs >= SMALL_MAX)
+        {
+            return *this %= Int(rhs);
+        }
+
+        unsigned long long r = small_mod(abs);
+        chunks_.clear();
+        if (sign_ != 0 && r != 0) // r.sign = this.sign
+        {
+            small_add(r);
+        }
+        return trim();
+    }
+
+    /// Return the quotient and remainder simultaneously where `rhs` is a primitive integer.
+    /// `this == (this / rhs) * rhs + this % rhs`
+    /// Divide by zero will throw a `runtime_error` exception.
+    template <std::integral T>
+    std::pair<Int, Int> divmod(T rhs) const
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        detail::check_zero(abs);
+
+        if (abs >= SMALL_MAX)
+        {
+            return divmod(Int(rhs));
+        }
+
+        if (sign_ == 0)
+        {
+            return {0, 0};
+        }
+
+        Int q = *this;
+        Int r = q.small_div(abs);
+        q.sign_ *= sign;
+        r.sign_ *= sign_; // r.sign = this.sign
+        return {q, r};
+    }
+
     /// Increase the value by 1 quickly.
     Int& operator++()
     {
@@ -652,6 +1363,53 @@ public:
         return Int(*this) %= rhs;
     }
 
+    /// Return this + `rhs` where `rhs` is a primitive integer.
+    template <std::integral T>
+    Int operator+(T rhs) const
+    {
+        return Int(*this) += rhs;
+    }
+
+    /// Return this - `rhs` where `rhs` is a primitive integer.
+    template <std::integral T>
+    Int operator-(T rhs) const
+    {
+        return Int(*this) -= rhs;
+    }
+
+    /// Return this * `rhs` where `rhs` is a primitive integer.
+    template <std::integral T>
+    Int operator*(T rhs) const
+    {
+        return Int(*this) *= rhs;
+    }
+
+    /// Return this / `rhs` where `rhs` is a primitive integer.
+    /// Divide by zero will throw a `runtime_error` exception.
+    template <std::integral T>
+    Int operator/(T rhs) const
+    {
+        return Int(*this) /= rhs;
+    }
+
+    /// Return this % `rhs` where `rhs` is a primitive integer, without copying this.
+    /// Divide by zero will throw a `runtime_error` exception.
+    template <std::integral T>
+    Int operator%(T rhs) const
+    {
+        auto [sign, abs] = sign_abs(rhs);
+        detail::check_zero(abs);
+
+        if (abs >= SMALL_MAX)
+        {
+            return *this % Int(rhs);
+        }
+
+        Int r = small_mod(abs);
+        r.sign_ *= sign_; // r.sign = this.sign
+        return r;
+    }
+
     /// Return the factorial of this.
     Int factorial() const
     {
@@ -688,48 +1446,160 @@ public:
     {
         if (*this < 2)
         {
-            return 2;
+            return 2;
+        }
+
+        Int prime = *this; // >= 2
+
+        // if prime is even, let it odd and < this, because prime > 2 is odd and while prime += 2
+        if (prime.is_even())
+        {
+            prime.abs_dec();
+        }
+
+        // prime >= 1
+        while (true)
+        {
+            prime += 2;
+
+            if (prime.is_prime())
+            {
+                break;
+            }
+        }
+
+        return prime;
+    }
+
+    /// Attempt to convert this integer to a number of the specified type `T`.
+    /// @tparam T a numeric type: int (default), long, double, etc. or any custom numeric type.
+    template <typename T = int>
+    T to_number() const
+    {
+        if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+        {
+            return static_cast<T>(to_double());
+        }
+
+        T result = 0;
+        for (const auto& chunk : chunks_ | std::views::reverse)
+        {
+            result = result * BASE + chunk;
+        }
+        return result * sign_;
+    }
+
+    /// Convert this integer to the nearest double (correctly rounded, ties to even).
+    /// If the integer is out of the range of double will throw an `overflow_error` exception.
+    double to_double() const
+    {
+        // at most two chunks: exact in 64 bits, let the hardware round
+        if (chunks_.size() <= 2)
+        {
+            unsigned long long abs = chunks_.empty() ? 0 : chunks_[0] + (chunks_.size() == 2 ? 1ULL * chunks_[1] * BASE : 0);
+            return sign_ * static_cast<double>(abs);
+        }
+
+        // a finite double has at most 309 integral digits
+        constexpr int MAX_DIGITS = std::numeric_limits<double>::max_exponent10 + 1;
+        char buffer[MAX_DIGITS + 1];
+        if (digits() > MAX_DIGITS)
+        {
+            throw std::overflow_error("Error: Int too large to convert to double.");
+        }
+
+        char* last = to_chars(buffer, buffer + sizeof(buffer)).ptr;
+        double result;
+        if (std::from_chars(buffer, last, result).ec != std::errc())
+        {
+            throw std::overflow_error("Error: Int too large to convert to double.");
+        }
+        return result;
+    }
+
+    /// Return `(mantissa, exponent)` such that this equals `mantissa * 2**exponent` with 0.5 <= |mantissa| < 1,
+    /// or `(0, 0)` if this is zero, like `math.frexp()` but without overflow.
+    /// The mantissa is correctly rounded when this fits in a double, otherwise has a relative error below `4 * (chunks + 1) * DBL_EPSILON`.
+    std::pair<double, long long> frexp() const
+    {
+        if (chunks_.size() * DIGITS_PER_CHUNK <= std::numeric_limits<double>::max_exponent10)
+        {
+            int exp;
+            double mantissa = std::frexp(to_double(), &exp);
+            return {mantissa, exp};
+        }
+
+        // leading three chunks times 10^(9 * rest), the ignored chunks are below the rounding error
+        std::size_t n = chunks_.size();
+        double top = (1.0 * chunks_[n - 1] * BASE + chunks_[n - 2]) * BASE + chunks_[n - 3];
+        int top_exp;
+        double mantissa = std::frexp(top, &top_exp);
+        long long exp = top_exp;
+
+        // 10^(9 * (n - 3)) by squaring in (mantissa, exponent) form
+        double base = 0.931322574615478515625; // 10^9 = 0.931322574615478515625 * 2^30
+        long long base_exp = 30;
+        for (std::size_t k = n - 3; k > 0; k >>= 1)
+        {
+            int e;
+            if (k & 1)
+            {
+                mantissa = std::frexp(mantissa * base, &e);
+                exp += base_exp + e;
+            }
+            base = std::frexp(base * base, &e);
+            base_exp = base_exp * 2 + e;
+        }
+
+        return {sign_ * mantissa, exp};
+    }
+
+    /*
+     * Static
+     */
+
+    /// Convert a finite double to Int exactly, truncating the fractional part toward zero.
+    static Int from_double(double number)
+    {
+        return ldexp(number, 0);
+    }
+
+    /// Return `mantissa * 2**exp` exactly, truncating the fractional part toward zero, like `math.ldexp()` but without overflow.
+    static Int ldexp(double mantissa, long long exp)
+    {
+        if (std::isnan(mantissa))
+        {
+            throw std::runtime_error("Error: Cannot convert NaN to Int.");
+        }
+        if (std::isinf(mantissa))
+        {
+            throw std::overflow_error("Error: Cannot convert infinity to Int.");
         }
 
-        Int prime = *this; // >= 2
+        // mantissa = bits * 2^(e - 53) with integral bits < 2^53
+        int e;
+        double fraction = std::frexp(mantissa, &e);
+        long long bits = static_cast<long long>(std::ldexp(fraction, 53));
+        long long shift = e + exp - 53;
 
-        // if prime is even, let it odd and < this, because prime > 2 is odd and while prime += 2
-        if (prime.is_even())
+        if (bits == 0 || shift <= -53)
         {
-            prime.abs_dec();
+            return 0;
         }
-
-        // prime >= 1
-        while (true)
+        if (shift < 0)
         {
-            prime += 2;
-
-            if (prime.is_prime())
-            {
-                break;
-            }
+            return bits / (1LL << -shift); // truncate toward zero
         }
 
-        return prime;
-    }
-
-    /// Attempt to convert this integer to a number of the specified type `T`.
-    /// @tparam T a numeric type: int (default), long, double, etc. or any custom numeric type.
-    template <typename T = int>
-    T to_number() const
-    {
-        T result = 0;
-        for (const auto& chunk : chunks_ | std::views::reverse)
+        Int result = bits;
+        for (; shift >= 30; shift -= 30)
         {
-            result = result * BASE + chunk;
+            result.small_mul(1ULL << 30);
         }
-        return result * sign_;
+        result.small_mul(1ULL << shift);
+        return result;
     }
 
-    /*
-     * Static
-     */
-
     /// Return the square root of integer `n`.
     static Int sqrt(const Int& n)
     {
@@ -786,8 +1656,11 @@ public:
             {
                 res = mod.is_zero() ? res * num : (res * num) % mod;
             }
-            num = mod.is_zero() ? num * num : (num * num) % mod;
             n.small_div(2);
+            if (!n.is_zero()) // the last square is never used
+            {
+                num = mod.is_zero() ? num * num : (num * num) % mod;
+            }
         }
 
         return res;
@@ -806,14 +1679,282 @@ public:
             return n.digits() - 1;
         }
 
-        Int num = n / base, res;
-        while (!num.is_zero())
+        if (base.chunks_.size() <= 2) // log2(2^s) == (bit_length-1) / s
         {
-            ++res;
-            num /= base;
+            unsigned long long b = base.chunks_.size() == 1 ? base.chunks_[0] : 1ULL * base.chunks_[1] * BASE + base.chunks_[0];
+            if (std::has_single_bit(b))
+            {
+                return (n.bit_length() - 1) / std::countr_zero(b);
+            }
         }
 
-        return res;
+        // estimate from the leading chunks, then correct by comparing with base^k
+        auto [n_mantissa, n_exp] = n.frexp();
+        auto [b_mantissa, b_exp] = base.frexp();
+        double estimate = (n_exp + std::log2(n_mantissa)) / (b_exp + std::log2(b_mantissa));
+        long long k = std::max(0LL, static_cast<long long>(estimate));
+
+        Int power = pow(base, k);
+        while (power > n)
+        {
+            power /= base;
+            --k;
+        }
+        for (power *= base; power <= n; power *= base)
+        {
+            ++k;
+        }
+
+        return k;
+    }
+
+    /// Return the sum of the integers in `range`.
+    /// Chunks are accumulated in a single pass without carry, so the sum is normalized only once.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::sum(List<Int>{"18446744073709551617", "-1", "1"}); // 18446744073709551617
+    /// ```
+    template <std::ranges::input_range R>
+    static Int sum(R&& range)
+    {
+        Accumulator acc;
+        for (const auto& n : range)
+        {
+            acc.add(n);
+        }
+        return acc.result();
+    }
+
+    /// Return the product of the integers in `range` (1 if `range` is empty).
+    /// A balanced product tree is used, so that operands of each multiplication have similar sizes.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::product(List<Int>{1, 2, 3, 4, 5}); // 120
+    /// ```
+    template <std::ranges::input_range R>
+    static Int product(R&& range)
+    {
+        std::vector<Int> level;
+        for (const auto& n : range)
+        {
+            level.emplace_back(n);
+        }
+
+        if (level.empty())
+        {
+            return 1;
+        }
+
+        // multiply adjacent pairs level by level
+        while (level.size() > 1)
+        {
+            const int size = level.size();
+            for (int i = 0; i + 1 < size; i += 2)
+            {
+                level[i / 2] = level[i] * level[i + 1];
+            }
+            if (size % 2 == 1)
+            {
+                level[size / 2] = std::move(level[size - 1]);
+            }
+            level.resize((size + 1) / 2);
+        }
+
+        return level[0];
+    }
+
+    /// Return the dot product of the integers in `a` and `b`, i.e. the sum of `a[i] * b[i]`.
+    /// If `a` and `b` have different lengths will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::dot(List<Int>{1, 2, 3}, List<Int>{4, 5, 6}); // 32
+    /// ```
+    template <std::ranges::input_range R1, std::ranges::input_range R2>
+    static Int dot(R1&& a, R2&& b)
+    {
+        Accumulator acc;
+
+        auto it_a = std::ranges::begin(a);
+        auto it_b = std::ranges::begin(b);
+        for (; it_a != std::ranges::end(a) && it_b != std::ranges::end(b); ++it_a, ++it_b)
+        {
+            const Int& x = *it_a; // no copy if the elements are Int
+            acc.add(x * *it_b);
+        }
+
+        if (it_a != std::ranges::end(a) || it_b != std::ranges::end(b))
+        {
+            throw std::runtime_error("Error: Require the same length for dot(a, b).");
+        }
+
+        return acc.result();
+    }
+
+    /// Return the number of ways to choose `k` items from `n` items without repetition and without order, like `math.comb()` in Python.
+    /// Return 0 if `k > n`. If `n` or `k` is negative or `n` exceeds INT_MAX will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::comb(5, 2); // 10
+    /// ```
+    static Int comb(const Int& n, const Int& k)
+    {
+        const char* message = "Error: Require 0 <= n <= INT_MAX and k >= 0 for comb(n, k).";
+        int a = factorial_arg(n, message);
+        if (k.is_negative())
+        {
+            throw std::runtime_error(message);
+        }
+        if (k > a)
+        {
+            return 0;
+        }
+
+        int b = k.to_number();
+        return factorial_quotient(a, {b, a - b});
+    }
+
+    /// Return the number of ways to choose `k` items from `n` items without repetition and with order, like `math.perm()` in Python.
+    /// Return 0 if `k > n`. If `n` or `k` is negative or `n` exceeds INT_MAX will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::perm(5, 2); // 20
+    /// ```
+    static Int perm(const Int& n, const Int& k)
+    {
+        const char* message = "Error: Require 0 <= n <= INT_MAX and k >= 0 for perm(n, k).";
+        int a = factorial_arg(n, message);
+        if (k.is_negative())
+        {
+            throw std::runtime_error(message);
+        }
+        if (k > a)
+        {
+            return 0;
+        }
+
+        return factorial_quotient(a, {a - k.to_number()});
+    }
+
+    /// Return the multinomial coefficient `(k1 + k2 + ...)! / (k1! * k2! * ...)` of the integers in `range`.
+    /// If any of them is negative or the sum exceeds INT_MAX will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::multinomial(List<Int>{2, 1, 1}); // 12
+    /// ```
+    template <std::ranges::input_range R>
+    static Int multinomial(R&& range)
+    {
+        const char* message = "Error: Require k >= 0 and sum(k) <= INT_MAX for multinomial(ks).";
+        std::vector<int> ks;
+        long long n = 0;
+        for (const auto& k : range)
+        {
+            ks.push_back(factorial_arg(k, message));
+            if ((n += ks.back()) > INT_MAX)
+            {
+                throw std::runtime_error(message);
+            }
+        }
+
+        return factorial_quotient(n, ks);
+    }
+
+    /// Return `a / b` where `b` is known to divide `a` exactly, faster than `a / b`.
+    /// The result is unspecified if `b` does not divide `a`.
+    /// Divide by zero will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::divexact(Int::pow(10, 30) * 7, 7); // 10^30
+    /// ```
+    static Int divexact(const Int& a, const Int& b)
+    {
+        detail::check_zero(b.sign_);
+
+        if (a.is_zero())
+        {
+            return 0;
+        }
+
+        // the lowest chunk of divisor must be invertible modulo base = 2^9 * 5^9, so divide out its factors 2 and 5 first
+        Int q = a.abs(), d = b.abs();
+        for (unsigned long long p : {2ull, 5ull})
+        {
+            unsigned long long power = 1;
+            while (d.small_mod(p) == 0)
+            {
+                d.small_div(p);
+                if ((power *= p) * p >= SMALL_MAX)
+                {
+                    q.small_div(power);
+                    power = 1;
+                }
+            }
+            if (power != 1)
+            {
+                q.small_div(power);
+            }
+        }
+
+        if (d.chunks_.size() == 1 && d.chunks_[0] == 1)
+        {
+            q.sign_ = a.sign_ * b.sign_;
+            return q;
+        }
+
+        // Jebelean's exact division: quotient chunks are determined from the least significant one
+        // by q[i] = r[i] * inverse(d[0]) (mod base), without trial quotient or correction
+        int r0 = BASE, r1 = d.chunks_[0], s0 = 0, s1 = 1; // inverse of d[0] modulo base, by extended Euclidean algorithm
+        while (r1 != 0)
+        {
+            int t = r0 / r1;
+            r0 = std::exchange(r1, r0 - t * r1);
+            s0 = std::exchange(s1, s0 - t * s1); // |s| <= base
+        }
+        const long long inv = cycle_mod(s0, BASE);
+
+        auto& r = q.chunks_.mut();
+        const auto& v = d.chunks_;
+        const int n = int(r.size()) - int(v.size()) + 1; // length of quotient, chunks above it are not needed
+        if (n <= 0)
+        {
+            return 0; // not divisible
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            const long long qi = r[i] * inv % BASE;
+
+            // r -= qi * v * base^i, only the chunks in [i, n) are updated
+            long long borrow = 0;
+            for (int j = i; j < n; ++j)
+            {
+                long long sub = (j - i < int(v.size()) ? qi * v[j - i] : 0) + borrow; // < b^2
+                long long tmp = r[j] - sub % BASE;
+                borrow = sub / BASE;
+                if (tmp < 0)
+                {
+                    tmp += BASE;
+                    ++borrow;
+                }
+                r[j] = tmp;
+                if (j - i >= int(v.size()) && borrow == 0)
+                {
+                    break;
+                }
+            }
+
+            r[i] = qi; // r[i] is zero now, reuse it for the quotient chunk
+        }
+        r.resize(n);
+
+        q.sign_ = a.sign_ * b.sign_;
+        return q.trim();
     }
 
     /// Calculate the greatest common divisor of two integers.
@@ -830,7 +1971,7 @@ public:
             return 0;
         }
 
-        return (a * b).abs() / gcd(a, b); // LCM = |a * b| / GCD
+        return divexact(a.abs(), gcd(a, b)) * b.abs(); // LCM = |a| / GCD * |b|
     }
 
     /// Generate a random integer in [`a`, `b`].
@@ -890,7 +2031,7 @@ public:
         std::uniform_int_distribution<int> most_chunk(std::pow(10, n - 1), std::pow(10, n) - 1);
         chunks.push_back(most_chunk(gen));
 
-        return Int(1, chunks);
+        return Int(1, std::move(chunks));
     }
 
     /// Calculate the `n`th term of the Fibonacci sequence: 0 (n=0), 1, 1, 2, 3, 5, ...
@@ -1008,31 +2149,270 @@ public:
         }
     }
 
+    /// Set the number of threads (default = 1) used by multiplication of very large integers in the current thread.
+    /// Operands are split only if each thread gets a slice of at least 256 chunks (2304 digits), so small products stay single-threaded.
+    /// If `n` is less than 1 will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int::set_threads(std::thread::hardware_concurrency());
+    /// ```
+    static void set_threads(int n)
+    {
+        if (n < 1)
+        {
+            throw std::runtime_error("Error: Require n >= 1 for set_threads(n).");
+        }
+        threads_ = n;
+    }
+
+    /// Return the number of threads used by multiplication of very large integers in the current thread.
+    static int threads()
+    {
+        return threads_;
+    }
+
     /*
      * Print / Input
      */
 
-    /// Convert the integer to a string.
-    std::string to_string() const
+    /// Convert the integer to a string based on 2-36 `base` (default = 10), without prefix.
+    /// If the base is out of range will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Int(-255).to_string(16); // "-ff"
+    /// ```
+    std::string to_string(int base = 10) const
     {
-        if (sign_ == 0)
+        if (base < 2 || base > 36)
         {
-            return "0";
+            throw std::runtime_error("Error: Require 2 <= base <= 36 for to_string(base).");
         }
 
-        std::ostringstream oss;
+        // digits + sign, "0" has no digits, number of digits in other bases is estimated from decimal digits
+        int size = (base == 10 ? digits() : int(digits() * std::log(10) / std::log(base)) + 2) + 1;
+        std::string str(size, '\0');
+        auto [ptr, ec] = to_chars(str.data(), str.data() + str.size(), base);
+        str.resize(ptr - str.data());
+        return str;
+    }
+
+    /// Convert the integer to a hexadecimal string prefixed with "0x", like `hex()` in Python.
+    std::string hex() const
+    {
+        return to_prefixed_string(16, "0x");
+    }
+
+    /// Convert the integer to a binary string prefixed with "0b", like `bin()` in Python.
+    std::string bin() const
+    {
+        return to_prefixed_string(2, "0b");
+    }
+
+    /// Convert the integer to an octal string prefixed with "0o", like `oct()` in Python.
+    std::string oct() const
+    {
+        return to_prefixed_string(8, "0o");
+    }
+
+    /// Write the integer into the character range [`first`, `last`) based on 2-36 `base` (default = 10), without allocation for base 10.
+    /// Like `std::to_chars`, return `{ptr, std::errc()}` on success, where `ptr` is one-past-the-end of the characters written,
+    /// or `{last, std::errc::value_too_large}` if the range is too small, in which case the contents of the range are unspecified.
+    ///
+    /// ### Example
+    /// ```
+    /// char buf[32];
+    /// auto [ptr, ec] = Int("-255").to_chars(buf, buf + 32, 16); // std::string_view(buf, ptr) == "-ff"
+    /// ```
+    std::to_chars_result to_chars(char* first, char* last, int base = 10) const
+    {
+        assert(base >= 2 && base <= 36);
+
         if (sign_ == -1)
         {
-            oss << '-';
+            if (first == last)
+            {
+                return {last, std::errc::value_too_large};
+            }
+            *first++ = '-';
+        }
+
+        if (sign_ == 0)
+        {
+            return std::to_chars(first, last, 0);
+        }
+
+        if (base == 10) // chunks are already decimal digits
+        {
+            if (last - first < digits())
+            {
+                return {last, std::errc::value_too_large};
+            }
+
+            first = std::to_chars(first, last, chunks_.back()).ptr;
+            for (int i = chunks_.size() - 2; i >= 0; --i) // every chunk except the most significant one is zero-padded
+            {
+                for (int j = DIGITS_PER_CHUNK - 1, chunk = chunks_[i]; j >= 0; --j, chunk /= 10)
+                {
+                    first[j] = '0' + chunk % 10;
+                }
+                first += DIGITS_PER_CHUNK;
+            }
+            return {first, std::errc()};
+        }
+
+        if (std::has_single_bit(unsigned(base))) // regroup the bits of binary words into digits in a single pass
+        {
+            const auto words = to_words();
+            const int shift = std::countr_zero(unsigned(base));
+            const long long bits = 32ll * (words.size() - 1) + std::bit_width(words.back());
+            const long long n = (bits + shift - 1) / shift;
+            if (last - first < n)
+            {
+                return {last, std::errc::value_too_large};
+            }
+
+            for (long long i = 0; i < n; ++i) // i-th digit from the least significant one
+            {
+                long long pos = i * shift;
+                std::uint64_t window = words[pos / 32];
+                if (std::size_t(pos / 32 + 1) < words.size())
+                {
+                    window |= std::uint64_t(words[pos / 32 + 1]) << 32; // a digit may straddle two words
+                }
+                first[n - 1 - i] = "0123456789abcdefghijklmnopqrstuvwxyz"[(window >> (pos % 32)) & (base - 1)];
+            }
+            return {first + n, std::errc()};
+        }
+
+        // group k digits together, so that one small_div produces k digits at once
+        int k = 1;
+        unsigned long long group = base;
+        while (group * base < SMALL_MAX)
+        {
+            group *= base;
+            ++k;
+        }
+
+        // produce digits from least significant to most significant, then reverse them
+        Int a = abs();
+        char* ptr = first;
+        while (!a.is_zero())
+        {
+            unsigned long long r = a.small_div(group);
+            for (int i = 0; i < k && (r != 0 || !a.is_zero()); ++i, r /= base) // no leading zeros
+            {
+                if (ptr == last)
+                {
+                    return {last, std::errc::value_too_large};
+                }
+                *ptr++ = "0123456789abcdefghijklmnopqrstuvwxyz"[r % base];
+            }
+        }
+        std::reverse(first, ptr);
+
+        return {ptr, std::errc()};
+    }
+
+    /// Parse an integer from the character range [`first`, `last`) based on 2-36 `base` (default = 10), without allocation for base 10
+    /// if `value` already has enough capacity. Like `std::from_chars`, only an optional leading '-' is accepted before the digits,
+    /// letters are case-insensitive, and the longest valid run of digits is consumed.
+    /// Return `{ptr, std::errc()}` on success, where `ptr` points at the first character not consumed,
+    /// or `{first, std::errc::invalid_argument}` if there is no digit, in which case `value` is unmodified.
+    ///
+    /// ### Example
+    /// ```
+    /// Int value;
+    /// std::string_view sv = "-ff, 1";
+    /// auto [ptr, ec] = Int::from_chars(sv.data(), sv.data() + sv.size(), value, 16); // value == -255, *ptr == ','
+    /// ```
+    static std::from_chars_result from_chars(const char* first, const char* last, Int& value, int base = 10)
+    {
+        if (base < 2 || base > 36)
+        {
+            return {first, std::errc::invalid_argument};
+        }
+
+        const bool negative = (first != last && *first == '-');
+        const char* begin = first + negative;
+        const char* end = digits_end(begin, last, base);
+        if (end == begin)
+        {
+            return {first, std::errc::invalid_argument};
+        }
+
+        value.sign_ = 1; // accumulate the absolute value, trim() will correct the sign at the end
+        value.chunks_.clear();
+
+        if (base == 10)
+        {
+            // every DIGITS_PER_CHUNK digits into a chunk (align right)
+            auto& chunks = value.chunks_.mut();
+            chunks.resize((end - begin + DIGITS_PER_CHUNK - 1) / DIGITS_PER_CHUNK);
+            const char* stop = end;
+            for (auto& chunk : chunks)
+            {
+                const char* start = stop - begin > DIGITS_PER_CHUNK ? stop - DIGITS_PER_CHUNK : begin;
+                chunk = 0;
+                for (const char* p = start; p != stop; ++p)
+                {
+                    chunk = chunk * 10 + (*p - '0'); // faster than (*p ^ 0x30) in -O2
+                }
+                stop = start;
+            }
+        }
+        else if (std::has_single_bit(unsigned(base)))
+        {
+            // pack the bits of the digits into 32-bit words from the most significant end, then value = value * 2^32 + word
+            const int bits = std::countr_zero(unsigned(base));
+            const long long total = (end - begin) * bits;
+            int need = total % 32 == 0 ? 32 : total % 32; // the most significant word may be partial
+            unsigned long long buffer = 0;
+            int buffered = 0;
+            for (const char* p = begin; p != end; ++p)
+            {
+                buffer = buffer << bits | DIGIT_VALUES[static_cast<unsigned char>(*p)];
+                buffered += bits;
+                if (buffered >= need)
+                {
+                    buffered -= need;
+                    if (!value.chunks_.empty())
+                    {
+                        value.small_mul(1ULL << 32);
+                    }
+                    value.small_add(buffer >> buffered);
+                    buffer &= (1ULL << buffered) - 1;
+                    need = 32;
+                }
+            }
+        }
+        else
+        {
+            // accumulate up to k digits in a small int, then value = value * base^k + group
+            for (const char* p = begin; p != end;)
+            {
+                unsigned long long group = 0, scale = 1;
+                for (; p != end && scale * base < SMALL_MAX; ++p)
+                {
+                    group = group * base + DIGIT_VALUES[static_cast<unsigned char>(*p)];
+                    scale *= base;
+                }
+                if (!value.chunks_.empty())
+                {
+                    value.small_mul(scale);
+                }
+                value.small_add(group);
+            }
         }
 
-        oss << *chunks_.rbegin();
-        for (auto it = chunks_.rbegin() + 1; it != chunks_.rend(); ++it)
+        value.trim();
+        if (negative)
         {
-            oss << std::setw(Int::DIGITS_PER_CHUNK) << std::setfill('0') << *it;
+            value.sign_ = -value.sign_;
         }
 
-        return oss.str();
+        return {end, std::errc()};
     }
 
     /// Output the integer to the specified output stream.
@@ -1053,6 +2433,24 @@ public:
     friend struct std::hash<pyincpp::Int>;
 };
 
+inline namespace literals
+{
+
+/// Create an integer from a literal like `123456789012345678901234567890_i`.
+/// The literal is validated and chunked at compile time, only copying the chunks at runtime.
+/// Hex (`0x`), binary (`0b`), octal (`0`) literals and digit separators (`'`) are supported.
+template <char... Chars>
+Int operator""_i()
+{
+    static constexpr auto literal = Int::parse_literal<Chars...>();
+    Int result(1, {});
+    result.chunks_.mut().assign(literal.chunks.begin(), literal.chunks.begin() + literal.size);
+    result.trim(); // zero has no chunks
+    return result;
+}
+
+} // namespace literals
+
 } // namespace pyincpp
 
 template <>
@@ -46,6 +46,12 @@ public:
     {
     }
 
+    /// Create a list from std::vector, taking over its buffer.
+    List(std::vector<T>&& vector) noexcept
+        : vector_(std::move(vector))
+    {
+    }
+
     /*
      * Comparison
      */
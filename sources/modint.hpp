@@ -0,0 +1,619 @@
+//! @file modint.hpp
+//! @author Chen QingYu <chen_qingyu@qq.com>
+//! @brief ModInt template class.
+//! @date 2026.10.18
+
+#ifndef MODINT_HPP
+#define MODINT_HPP
+
+#include "detail.hpp"
+
+#include "int.hpp"
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // _umul128 _udiv128
+#endif
+
+// Whether 64x64 -> 128-bit multiplication and 128/64-bit division are available.
+#if defined(__SIZEOF_INT128__) || (defined(_MSC_VER) && defined(_M_X64))
+#define PYINCPP_WIDE_64 1
+#else
+#define PYINCPP_WIDE_64 0
+#endif
+
+namespace pyincpp
+{
+
+/// ModInt provides support for modular integer arithmetic.
+///
+/// `ModInt<M>` has the compile-time modulus `M`, and `ModInt<>` has a runtime modulus which can be any `Int` greater than 1.
+/// Values are kept in a native word, 32 bits for `ModInt<M>` and 64 bits for `ModInt<>`
+/// (32 bits on compilers without 128-bit products, neither `__int128` nor `_umul128`).
+/// Only an odd modulus below 2^31 for `ModInt<M>`, or below 2^63 for `ModInt<>`, keeps values in Montgomery form,
+/// so that multiplication needs no division. Other moduli that fit in the word reduce double-width products with a division,
+/// and larger runtime moduli use `Int`.
+template <std::uint32_t M = 0>
+class ModInt
+{
+    static_assert(M != 1, "Require modulus > 1.");
+
+private:
+    // Native word of the value, 32 bits for compile-time modulus and 64 bits for runtime modulus if available.
+    using Word = std::conditional_t<M == 0 && PYINCPP_WIDE_64, std::uint64_t, std::uint32_t>;
+
+    // Parameters of a modulus that fits in a word, R = 2^BITS for Montgomery form.
+    struct Native
+    {
+        static constexpr int BITS = sizeof(Word) * 8;
+
+        // Modulus, 0 means the modulus does not fit in a word.
+        Word mod = 0;
+
+        // -mod^(-1) mod R, 0 means Montgomery form is not used.
+        Word inv = 0;
+
+        // R^2 mod mod.
+        Word r2 = 0;
+
+        // Return the high word of `a * b`, and the low word in `lo`.
+        static constexpr Word mul_wide(Word a, Word b, Word& lo)
+        {
+            if constexpr (BITS == 32)
+            {
+                std::uint64_t t = std::uint64_t(a) * b;
+                lo = Word(t);
+                return Word(t >> 32);
+            }
+            else
+            {
+#if defined(__SIZEOF_INT128__)
+                __extension__ using u128 = unsigned __int128;
+                u128 t = u128(a) * b;
+                lo = Word(t);
+                return Word(t >> 64);
+#elif PYINCPP_WIDE_64
+                unsigned __int64 hi;
+                lo = _umul128(a, b, &hi);
+                return hi;
+#else
+                return lo = 0; // unreachable, the word has 32 bits
+#endif
+            }
+        }
+
+        // Return `(hi * R + lo) mod m`, require hi < m.
+        static constexpr Word mod_wide(Word hi, Word lo, Word m)
+        {
+            if (hi == 0)
+            {
+                return lo % m; // single-word division if the product fits
+            }
+
+            if constexpr (BITS == 32)
+            {
+                return Word(((std::uint64_t(hi) << 32) | lo) % m);
+            }
+            else
+            {
+#if defined(__SIZEOF_INT128__)
+                __extension__ using u128 = unsigned __int128;
+                return Word(((u128(hi) << 64) | lo) % m);
+#elif PYINCPP_WIDE_64
+                unsigned __int64 rem;
+                _udiv128(hi, lo, m, &rem);
+                return rem;
+#else
+                return 0; // unreachable, the word has 32 bits
+#endif
+            }
+        }
+
+        constexpr Native() = default;
+
+        constexpr explicit Native(Word m)
+            : mod(m)
+        {
+            // Montgomery reduction requires odd modulus, and mod < R/2 so that `(t + u * mod) / R` fits in a word
+            if (m % 2 == 1 && m < (Word(1) << (BITS - 1)))
+            {
+                Word x = m; // m * m = 1 (mod 8) for odd m, so x = m^(-1) mod 2^3
+                for (int bits = 3; bits < BITS; bits *= 2)
+                {
+                    x *= 2 - m * x; // Newton's iteration doubles the number of correct bits
+                }
+                inv = -x;
+
+                Word r = Word(0 - m) % m; // R mod m = (R - m) mod m
+                Word lo = 0;
+                Word hi = mul_wide(r, r, lo);
+                r2 = mod_wide(hi, lo, m);
+            }
+        }
+
+        // Montgomery reduction, return (hi * R + lo) * R^(-1) mod `mod`, require hi < mod.
+        constexpr Word reduce(Word hi, Word lo) const
+        {
+            Word u = lo * inv; // t + u * mod = 0 (mod R)
+            Word um_lo = 0;
+            Word um_hi = mul_wide(u, mod, um_lo);
+            Word r = hi + um_hi + (lo != 0); // the low words sum to R unless both are 0, so r = (t + u * mod) / R < 2 * mod
+            return r >= mod ? r - mod : r;
+        }
+
+        // Convert a value less than `mod` to internal form.
+        constexpr Word to(Word a) const
+        {
+            if (!inv)
+            {
+                return a;
+            }
+            Word lo = 0;
+            Word hi = mul_wide(a, r2, lo);
+            return reduce(hi, lo);
+        }
+
+        // Convert internal form to a value less than `mod`.
+        constexpr Word from(Word a) const
+        {
+            return inv ? reduce(0, a) : a;
+        }
+
+        constexpr Word add(Word a, Word b) const
+        {
+            Word s = a + b;
+            return s < a || s >= mod ? s - mod : s; // s < a if the sum wraps around
+        }
+
+        constexpr Word sub(Word a, Word b) const
+        {
+            return a >= b ? a - b : a + (mod - b);
+        }
+
+        constexpr Word mul(Word a, Word b) const
+        {
+            Word lo = 0;
+            Word hi = mul_wide(a, b, lo);
+            return inv ? reduce(hi, lo) : mod_wide(hi, lo, mod);
+        }
+    };
+
+    // Placeholder of the runtime-only members for compile-time modulus.
+    struct Empty
+    {
+    };
+
+    // Parameters of the compile-time modulus.
+    static constexpr Native static_native_ = Native(M);
+
+    // Parameters of the runtime modulus.
+    [[no_unique_address]] std::conditional_t<M == 0, Native, Empty> native_;
+
+    // Runtime modulus that does not fit in a word.
+    [[no_unique_address]] std::conditional_t<M == 0, Int, Empty> big_mod_;
+
+    // Value in [0, big_mod_) if the modulus does not fit in a word.
+    [[no_unique_address]] std::conditional_t<M == 0, Int, Empty> big_value_;
+
+    // Value in internal form if the modulus fits in a word.
+    Word value_ = 0;
+
+    // Get the parameters of the modulus.
+    const Native& native() const
+    {
+        if constexpr (M != 0)
+        {
+            return static_native_;
+        }
+        else
+        {
+            return native_;
+        }
+    }
+
+    // Whether the modulus does not fit in a word. Always false for compile-time modulus.
+    bool is_big() const
+    {
+        return native().mod == 0;
+    }
+
+    // Check whether two runtime moduli are the same.
+    void check_modulus(const ModInt& that) const
+    {
+        if constexpr (M == 0)
+        {
+            if (native_.mod != that.native_.mod || big_mod_ != that.big_mod_)
+            {
+                throw std::runtime_error("Error: Require the same modulus.");
+            }
+        }
+    }
+
+    // Return x such that a * x = 1 (mod m), for T is long long or Int.
+    template <typename T>
+    static T mod_inverse(const T& a, const T& m)
+    {
+        // extended Euclidean algorithm, only track the coefficient of a
+        T old_r = a, r = m, old_s = 1, s = 0;
+        while (r != 0)
+        {
+            T q = old_r / r;
+            old_r = std::exchange(r, old_r - q * r);
+            old_s = std::exchange(s, old_s - q * s);
+        }
+
+        if (old_r != 1)
+        {
+            throw std::runtime_error("Error: Base is not invertible for the given modulus.");
+        }
+
+        return old_s < 0 ? old_s + m : old_s;
+    }
+
+public:
+    /*
+     * Constructor
+     */
+
+    /// Create a modular integer with value `value mod M` (default = 0) for compile-time modulus.
+    /// @tparam T a primitive integer type: int (default), long, etc.
+    template <std::integral T = int>
+        requires(M != 0)
+    ModInt(T value = 0)
+    {
+        std::uint64_t r;
+        if constexpr (std::is_signed_v<T>)
+        {
+            r = value < 0 ? (M - (0ull - std::uint64_t(value)) % M) % M : std::uint64_t(value) % M;
+        }
+        else
+        {
+            r = std::uint64_t(value) % M;
+        }
+        value_ = static_native_.to(r);
+    }
+
+    /// Create a modular integer with value `value mod M` for compile-time modulus.
+    ModInt(const Int& value)
+        requires(M != 0)
+    {
+        long long r = (value % M).template to_number<long long>(); // r.sign = value.sign
+        value_ = static_native_.to(r < 0 ? r + M : r);
+    }
+
+    /// Create a modular integer with value `value mod modulus` for runtime modulus.
+    /// Require `modulus > 1`, otherwise will throw a `runtime_error` exception.
+    ModInt(const Int& value, const Int& modulus)
+        requires(M == 0)
+    {
+        if (modulus <= 1)
+        {
+            throw std::runtime_error("Error: Require modulus > 1.");
+        }
+
+        Int r = value % modulus;
+        if (r.is_negative())
+        {
+            r += modulus;
+        }
+
+        if (modulus <= std::numeric_limits<Word>::max())
+        {
+            native_ = Native(modulus.to_number<Word>());
+            value_ = native_.to(r.to_number<Word>());
+        }
+        else
+        {
+            big_mod_ = modulus;
+            big_value_ = std::move(r);
+        }
+    }
+
+    /// Copy constructor.
+    ModInt(const ModInt& that) = default;
+
+    /// Move constructor.
+    ModInt(ModInt&& that) noexcept = default;
+
+    /*
+     * Comparison
+     */
+
+    /// Determine whether this modular integer is equal to another one (same modulus and same value).
+    bool operator==(const ModInt& that) const
+    {
+        if constexpr (M == 0)
+        {
+            if (native_.mod != that.native_.mod || big_mod_ != that.big_mod_ || big_value_ != that.big_value_)
+            {
+                return false;
+            }
+        }
+
+        return value_ == that.value_;
+    }
+
+    /*
+     * Assignment
+     */
+
+    /// Copy assignment operator.
+    ModInt& operator=(const ModInt& that) = default;
+
+    /// Move assignment operator.
+    ModInt& operator=(ModInt&& that) noexcept = default;
+
+    /*
+     * Examination
+     */
+
+    /// Return the value in [0, modulus).
+    Int value() const
+    {
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                return big_value_;
+            }
+        }
+
+        return native().from(value_);
+    }
+
+    /// Return the modulus.
+    Int modulus() const
+    {
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                return big_mod_;
+            }
+        }
+
+        return native().mod;
+    }
+
+    /// Determine whether the modular integer is zero quickly.
+    bool is_zero() const
+    {
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                return big_value_.is_zero();
+            }
+        }
+
+        return value_ == 0; // 0 in Montgomery form is still 0
+    }
+
+    /*
+     * Manipulation
+     */
+
+    /// Return this += `rhs`.
+    ModInt& operator+=(const ModInt& rhs)
+    {
+        check_modulus(rhs);
+
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                big_value_ += rhs.big_value_;
+                if (big_value_ >= big_mod_)
+                {
+                    big_value_ -= big_mod_;
+                }
+                return *this;
+            }
+        }
+
+        value_ = native().add(value_, rhs.value_);
+        return *this;
+    }
+
+    /// Return this -= `rhs`.
+    ModInt& operator-=(const ModInt& rhs)
+    {
+        check_modulus(rhs);
+
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                big_value_ -= rhs.big_value_;
+                if (big_value_.is_negative())
+                {
+                    big_value_ += big_mod_;
+                }
+                return *this;
+            }
+        }
+
+        value_ = native().sub(value_, rhs.value_);
+        return *this;
+    }
+
+    /// Return this *= `rhs`.
+    ModInt& operator*=(const ModInt& rhs)
+    {
+        check_modulus(rhs);
+
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                big_value_ = big_value_ * rhs.big_value_ % big_mod_;
+                return *this;
+            }
+        }
+
+        value_ = native().mul(value_, rhs.value_);
+        return *this;
+    }
+
+    /// Return this /= `rhs`.
+    /// If `rhs` is not invertible will throw a `runtime_error` exception.
+    ModInt& operator/=(const ModInt& rhs)
+    {
+        return *this *= rhs.inverse();
+    }
+
+    /*
+     * Production
+     */
+
+    /// Return the copy of this.
+    ModInt operator+() const
+    {
+        return *this;
+    }
+
+    /// Return the opposite value of this.
+    ModInt operator-() const
+    {
+        ModInt result = *this;
+
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                if (!big_value_.is_zero())
+                {
+                    result.big_value_ = big_mod_ - big_value_;
+                }
+                return result;
+            }
+        }
+
+        result.value_ = native().sub(0, value_); // negation is linear, works in Montgomery form
+        return result;
+    }
+
+    /// Return this + `rhs`.
+    ModInt operator+(const ModInt& rhs) const
+    {
+        return ModInt(*this) += rhs;
+    }
+
+    /// Return this - `rhs`.
+    ModInt operator-(const ModInt& rhs) const
+    {
+        return ModInt(*this) -= rhs;
+    }
+
+    /// Return this * `rhs`.
+    ModInt operator*(const ModInt& rhs) const
+    {
+        return ModInt(*this) *= rhs;
+    }
+
+    /// Return this / `rhs`.
+    /// If `rhs` is not invertible will throw a `runtime_error` exception.
+    ModInt operator/(const ModInt& rhs) const
+    {
+        return ModInt(*this) /= rhs;
+    }
+
+    /// Return the modular multiplicative inverse of this.
+    /// If this is not invertible (not coprime to the modulus) will throw a `runtime_error` exception.
+    ModInt inverse() const
+    {
+        ModInt result = *this;
+
+        if constexpr (M == 0)
+        {
+            if (is_big())
+            {
+                result.big_value_ = mod_inverse(big_value_, big_mod_);
+                return result;
+            }
+        }
+
+        const Native& n = native();
+        if (n.mod <= LLONG_MAX) // the coefficients are bounded by the modulus
+        {
+            result.value_ = n.to(mod_inverse<long long>(n.from(value_), n.mod));
+        }
+        else
+        {
+            result.value_ = n.to(mod_inverse<Int>(n.from(value_), n.mod).template to_number<Word>());
+        }
+        return result;
+    }
+
+    /*
+     * Static
+     */
+
+    /// Return `base**exp` in modular arithmetic. Negative `exp` means the power of the inverse.
+    static ModInt pow(const ModInt& base, const Int& exp)
+    {
+        if (exp.is_negative())
+        {
+            return pow(base.inverse(), -exp);
+        }
+
+        // fast power algorithm, all multiplications stay in Montgomery form
+        ModInt num = base, res = base;
+        if (base.is_big())
+        {
+            if constexpr (M == 0)
+            {
+                res.big_value_ = 1; // 1 mod m = 1 for m > 1
+            }
+        }
+        else
+        {
+            res.value_ = base.native().to(1);
+        }
+
+        Int n = exp;
+        while (!n.is_zero())
+        {
+            if (n.is_odd())
+            {
+                res *= num;
+            }
+            num *= num;
+            n /= 2;
+        }
+
+        return res;
+    }
+
+    /*
+     * Print / Input
+     */
+
+    /// Output the value of the modular integer to the specified output stream.
+    friend std::ostream& operator<<(std::ostream& os, const ModInt& modint)
+    {
+        return os << modint.value();
+    }
+
+    friend struct std::hash<pyincpp::ModInt<M>>;
+};
+
+} // namespace pyincpp
+
+template <std::uint32_t M>
+struct std::hash<pyincpp::ModInt<M>> // partial specialization
+{
+    std::size_t operator()(const pyincpp::ModInt<M>& modint) const
+    {
+        if constexpr (M == 0)
+        {
+            if (modint.is_big())
+            {
+                return std::hash<pyincpp::Int>{}(modint.big_value_);
+            }
+        }
+
+        return std::hash<decltype(modint.value_)>{}(modint.value_);
+    }
+};
+
+#endif // MODINT_HPP
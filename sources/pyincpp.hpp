@@ -15,6 +15,8 @@
 #include "fraction.hpp"
 #include "int.hpp"
 #include "list.hpp"
+#include "modint.hpp"
+#include "rope.hpp"
 #include "set.hpp"
 #include "str.hpp"
 #include "tuple.hpp"
@@ -0,0 +1,511 @@
+//! @file rope.hpp
+//! @author Chen QingYu <chen_qingyu@qq.com>
+//! @brief Rope class.
+//! @date 2026.10.18
+
+#ifndef ROPE_HPP
+#define ROPE_HPP
+
+#include "detail.hpp"
+
+#include "str.hpp"
+
+namespace pyincpp
+{
+
+/// Rope is immutable sequence of characters for building large texts from pieces.
+///
+/// The characters are stored in chunks at the leaves of a balanced binary tree, and the nodes are shared between ropes.
+/// So concatenation, split, insertion and erasure take O(log N) time and never copy the whole text.
+class Rope
+{
+private:
+    // Maximum number of characters in a leaf.
+    static constexpr int CHUNK_SIZE = 512;
+
+    // Node of the tree, a leaf if it has no children.
+    struct Node
+    {
+        // Children, both null for a leaf.
+        std::shared_ptr<const Node> left, right;
+
+        // Characters of a leaf.
+        std::string text;
+
+        // Number of characters in the subtree.
+        int size;
+
+        // Height of the subtree, 0 for a leaf.
+        int height;
+    };
+
+    using Ptr = std::shared_ptr<const Node>;
+
+    // Root of the tree, null if empty.
+    Ptr root_;
+
+    // Helper constructor.
+    Rope(Ptr root)
+        : root_(std::move(root))
+    {
+    }
+
+    static int size_of(const Ptr& node)
+    {
+        return node ? node->size : 0;
+    }
+
+    static int height_of(const Ptr& node)
+    {
+        return node ? node->height : -1;
+    }
+
+    static Ptr make_leaf(std::string text)
+    {
+        int size = text.size();
+        return std::make_shared<const Node>(Node{nullptr, nullptr, std::move(text), size, 0});
+    }
+
+    static Ptr make_node(Ptr left, Ptr right)
+    {
+        int size = left->size + right->size;
+        int height = std::max(left->height, right->height) + 1;
+        return std::make_shared<const Node>(Node{std::move(left), std::move(right), {}, size, height});
+    }
+
+    // Build a balanced tree from the characters in [`first`, `first + n`).
+    static Ptr build(const char* first, int n)
+    {
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        if (n <= CHUNK_SIZE)
+        {
+            return make_leaf(std::string(first, n));
+        }
+
+        int half = (n / CHUNK_SIZE + 1) / 2 * CHUNK_SIZE; // keep leaves full
+        return make_node(build(first, half), build(first + half, n - half));
+    }
+
+    // Make a node whose children heights differ by at most 2, with rotations.
+    static Ptr balance(Ptr left, Ptr right)
+    {
+        if (left->height > right->height + 1)
+        {
+            if (left->left->height >= left->right->height)
+            {
+                return make_node(left->left, make_node(left->right, std::move(right)));
+            }
+            return make_node(make_node(left->left, left->right->left), make_node(left->right->right, std::move(right)));
+        }
+
+        if (right->height > left->height + 1)
+        {
+            if (right->right->height >= right->left->height)
+            {
+                return make_node(make_node(std::move(left), right->left), right->right);
+            }
+            return make_node(make_node(std::move(left), right->left->left), make_node(right->left->right, right->right));
+        }
+
+        return make_node(std::move(left), std::move(right));
+    }
+
+    // Concatenate two trees. O(|h(a) - h(b)|)
+    static Ptr concat(const Ptr& a, const Ptr& b)
+    {
+        if (!a || !b)
+        {
+            return a ? a : b;
+        }
+
+        // merge small leaves, so that appending characters one by one does not make tiny leaves
+        if (a->height == 0 && b->height == 0 && a->size + b->size <= CHUNK_SIZE)
+        {
+            return make_leaf(a->text + b->text);
+        }
+
+        if (a->height > b->height + 1)
+        {
+            return balance(a->left, concat(a->right, b));
+        }
+        if (b->height > a->height + 1)
+        {
+            return balance(concat(a, b->left), b->right);
+        }
+        return make_node(a, b);
+    }
+
+    // Split a tree into [0, `index`) and [`index`, size). O(log N)
+    static std::pair<Ptr, Ptr> split(const Ptr& node, int index)
+    {
+        if (index <= 0 || index >= size_of(node))
+        {
+            return index <= 0 ? std::pair<Ptr, Ptr>{nullptr, node} : std::pair<Ptr, Ptr>{node, nullptr};
+        }
+
+        if (node->height == 0)
+        {
+            return {make_leaf(node->text.substr(0, index)), make_leaf(node->text.substr(index))};
+        }
+
+        if (index <= node->left->size)
+        {
+            auto [l, r] = split(node->left, index);
+            return {l, concat(r, node->right)};
+        }
+        auto [l, r] = split(node->right, index - node->left->size);
+        return {concat(node->left, l), r};
+    }
+
+public:
+    /// Forward iterator over the characters of a rope.
+    class Iterator
+    {
+    private:
+        // Nodes whose characters are yet to be visited, the top is the next one.
+        std::vector<const Node*> stack_;
+
+        // Current leaf, null for the end.
+        const Node* leaf_ = nullptr;
+
+        // Position in the current leaf.
+        int pos_ = 0;
+
+        // Descend to the leftmost leaf of `node`, pushing the right siblings on the way.
+        void descend(const Node* node)
+        {
+            while (node->height != 0)
+            {
+                stack_.push_back(node->right.get());
+                node = node->left.get();
+            }
+            leaf_ = node;
+            pos_ = 0;
+        }
+
+        friend class Rope;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = const char&;
+
+        Iterator() = default;
+
+        reference operator*() const
+        {
+            return leaf_->text[pos_];
+        }
+
+        Iterator& operator++()
+        {
+            if (++pos_ == leaf_->size)
+            {
+                if (stack_.empty())
+                {
+                    leaf_ = nullptr;
+                    pos_ = 0;
+                }
+                else
+                {
+                    const Node* next = stack_.back();
+                    stack_.pop_back();
+                    descend(next);
+                }
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const Iterator& that) const
+        {
+            return leaf_ == that.leaf_ && pos_ == that.pos_;
+        }
+    };
+
+    /*
+     * Constructor
+     */
+
+    /// Create an empty rope.
+    Rope() = default;
+
+    /// Create a rope from null-terminated characters.
+    Rope(const char* chars)
+        : root_(build(chars, std::strlen(chars)))
+    {
+    }
+
+    /// Create a rope from a string.
+    Rope(const Str& string)
+        : root_(build(string.data(), string.size()))
+    {
+    }
+
+    /// Copy constructor, O(1).
+    Rope(const Rope& that) = default;
+
+    /// Move constructor.
+    Rope(Rope&& that) noexcept = default;
+
+    /*
+     * Comparison
+     */
+
+    /// Determine whether this rope is equal to another rope.
+    bool operator==(const Rope& that) const
+    {
+        return size() == that.size() && (root_ == that.root_ || std::equal(begin(), end(), that.begin()));
+    }
+
+    /*
+     * Assignment
+     */
+
+    /// Copy assignment operator, O(1).
+    Rope& operator=(const Rope& that) = default;
+
+    /// Move assignment operator.
+    Rope& operator=(Rope&& that) noexcept = default;
+
+    /*
+     * Iterator
+     */
+
+    /// Return an iterator to the first char of the rope.
+    Iterator begin() const
+    {
+        Iterator it;
+        if (root_)
+        {
+            it.descend(root_.get());
+        }
+        return it;
+    }
+
+    /// Return an iterator to the char following the last char of the rope.
+    Iterator end() const
+    {
+        return Iterator();
+    }
+
+    /*
+     * Access
+     */
+
+    /// Return the const reference to element at the specified position in the rope. O(log N)
+    /// Index can be negative, like Python's string: rope[-1] gets the last element.
+    const char& operator[](int index) const
+    {
+        detail::check_bounds(index, -size(), size());
+
+        index = index >= 0 ? index : index + size();
+        const Node* node = root_.get();
+        while (node->height != 0)
+        {
+            if (index < node->left->size)
+            {
+                node = node->left.get();
+            }
+            else
+            {
+                index -= node->left->size;
+                node = node->right.get();
+            }
+        }
+        return node->text[index];
+    }
+
+    /*
+     * Examination
+     */
+
+    /// Return the number of elements in the rope.
+    int size() const
+    {
+        return size_of(root_);
+    }
+
+    /// Return true if the rope contains no elements.
+    bool is_empty() const
+    {
+        return !root_;
+    }
+
+    /// Return the index of the first occurrence of the specified pattern starting from `start`.
+    /// Or -1 if the rope does not contain the pattern.
+    /// The chunks are searched in turn, without materializing the whole rope.
+    int find(const Str& pattern, int start = 0) const
+    {
+        start = std::max(start, 0);
+        if (start > size())
+        {
+            return -1;
+        }
+        if (pattern.is_empty())
+        {
+            return start;
+        }
+
+        // search each chunk together with the last (pattern.size - 1) characters before it
+        const std::string_view target(pattern.data(), pattern.size());
+        const Ptr tail = split(root_, start).second;
+        std::string window;
+        int window_start = start; // index of window[0] in the rope
+        std::vector<const Node*> stack;
+        if (tail)
+        {
+            stack.push_back(tail.get());
+        }
+        while (!stack.empty())
+        {
+            const Node* node = stack.back();
+            stack.pop_back();
+            if (node->height != 0)
+            {
+                stack.push_back(node->right.get());
+                stack.push_back(node->left.get());
+                continue;
+            }
+
+            window += node->text;
+            if (auto pos = window.find(target); pos != std::string::npos)
+            {
+                return window_start + int(pos);
+            }
+            int keep = std::min(int(window.size()), int(target.size()) - 1);
+            window_start += window.size() - keep;
+            window.erase(0, window.size() - keep);
+        }
+
+        return -1;
+    }
+
+    /// Return `true` if the rope contains the specified `pattern`.
+    bool contains(const Str& pattern) const
+    {
+        return find(pattern) != -1;
+    }
+
+    /*
+     * Production
+     */
+
+    /// Return the concatenation of this and `rope`. O(log N)
+    Rope operator+(const Rope& rope) const
+    {
+        return concat(root_, rope.root_);
+    }
+
+    /// Append `rope` to the end of this. O(log N)
+    Rope& operator+=(const Rope& rope)
+    {
+        root_ = concat(root_, rope.root_);
+        return *this;
+    }
+
+    /// Split the rope into [0, `index`) and [`index`, size). O(log N)
+    std::pair<Rope, Rope> split_at(int index) const
+    {
+        detail::check_bounds(index, 0, size() + 1);
+
+        auto [l, r] = split(root_, index);
+        return {Rope(l), Rope(r)};
+    }
+
+    /// Return a copy of the rope with `rope` inserted before position `index`. O(log N)
+    Rope insert(int index, const Rope& rope) const
+    {
+        detail::check_bounds(index, 0, size() + 1);
+
+        auto [l, r] = split(root_, index);
+        return concat(concat(l, rope.root_), r);
+    }
+
+    /// Return a copy of the rope and erase the contents of the rope in the range [`start`, `stop`). O(log N)
+    Rope erase(int start, int stop) const
+    {
+        detail::check_bounds(start, 0, size() + 1);
+        detail::check_bounds(stop, 0, size() + 1);
+
+        if (start >= stop)
+        {
+            return *this;
+        }
+
+        auto [l, rest] = split(root_, start);
+        return concat(l, split(rest, stop - start).second);
+    }
+
+    /// Return the part of the rope in the range [`start`, `stop`). O(log N)
+    /// Index can be negative, like Python's string.
+    Rope slice(int start, int stop) const
+    {
+        detail::check_bounds(start, -size(), size() + 1);
+        detail::check_bounds(stop, -size() - 1, size() + 1);
+
+        start = start < 0 ? start + size() : start;
+        stop = stop < 0 ? stop + size() : stop;
+
+        if (start >= stop)
+        {
+            return Rope();
+        }
+
+        return split(split(root_, stop).first, start).second;
+    }
+
+    /// Materialize the rope into a string. O(N)
+    Str to_str() const
+    {
+        std::string buffer;
+        buffer.reserve(size());
+
+        std::vector<const Node*> stack;
+        if (root_)
+        {
+            stack.push_back(root_.get());
+        }
+        while (!stack.empty())
+        {
+            const Node* node = stack.back();
+            stack.pop_back();
+            if (node->height == 0)
+            {
+                buffer += node->text;
+            }
+            else
+            {
+                stack.push_back(node->right.get());
+                stack.push_back(node->left.get());
+            }
+        }
+
+        return buffer;
+    }
+
+    /*
+     * Print / Input
+     */
+
+    /// Output the rope to the specified output stream.
+    friend std::ostream& operator<<(std::ostream& os, const Rope& rope)
+    {
+        return os << rope.to_str();
+    }
+};
+
+} // namespace pyincpp
+
+#endif // ROPE_HPP
@@ -8,128 +8,2720 @@
 
 #include "detail.hpp"
 
+#include "dict.hpp"
 #include "int.hpp"
 #include "list.hpp"
 
 namespace pyincpp
 {
 
-/// Str is immutable sequence of characters.
-class Str
+/// StrView is non-owning view of a sequence of characters, with the read-only API of `Str`.
+///
+/// The viewed characters must outlive the view. Slicing, stripping and splitting a view never copy the characters.
+class StrView
 {
 private:
-    // String.
-    std::string str_;
-
-    // Used for FSM.
-    enum state
-    {
-        S_START = 0,    // start with blank character
-        S_SIGN = 1,     // positive or negative sign
-        S_INT = 2,      // integer part
-        S_POINT = 3,    // decimal point that doesn't have left digit
-        S_DEC = 4,      // decimal part
-        S_EXP = 5,      // scientific notation identifier
-        S_EXP_SIGN = 6, // positive or negative sign of exponent part
-        S_EXP_NUM = 7,  // exponent part number
-        S_END = 8,      // end with blank character
-        S_OTHER = 9,    // other
+    // Viewed characters.
+    std::string_view str_;
+
+    // Test whether the character is blank: ' ', '\n', '\t', '\r'.
+    static bool is_blank(char ch)
+    {
+        return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r';
+    }
+
+    // Return infinity or zero for a decimal number in [`first`, `last`) that is out of the range of double,
+    // decided by the decimal exponent of its first significant digit.
+    static double out_of_range_decimal(const char* first, const char* last)
+    {
+        const char* e = std::find_if(first, last, [](char ch)
+                                     { return ch == 'e' || ch == 'E'; });
+        const char* p = std::find_if(first, e, [](char ch)
+                                     { return ch != '0'; });
+        long long magnitude = std::find(p, e, '.') - p; // significant integer digits
+        if (magnitude == 0)
+        {
+            magnitude = -(std::find_if(p + 1, e, [](char ch)
+                                       { return ch != '0'; }) -
+                          (p + 1)); // zeros after the point
+        }
+
+        long long exponent = 0;
+        if (e != last)
+        {
+            e += e[1] == '+';
+            if (std::from_chars(e + 1, last, exponent).ec == std::errc::result_out_of_range)
+            {
+                exponent = e[1] == '-' ? LLONG_MIN / 2 : LLONG_MAX / 2;
+            }
+        }
+        return magnitude + exponent > 0 ? HUGE_VAL : 0.0;
+    }
+
+    // Parse a decimal number [+-](digits[.digits]|.digits)[(e|E)[+-]digits] at the beginning of [`first`, `last`),
+    // or [+-](inf|infinity|nan) case-insensitive if `special`.
+    // Return the end of the number, or null if there is no number.
+    // Validation and correctly rounded conversion are done in one pass by std::from_chars, without allocation.
+    static const char* scan_decimal(const char* first, const char* last, double& value, bool special)
+    {
+        const bool negative = first != last && *first == '-';
+        first += first != last && (*first == '+' || *first == '-');
+        if (first == last)
+        {
+            return nullptr;
+        }
+
+        if ((*first >= '0' && *first <= '9') || *first == '.') // from_chars would accept a second sign or "inf"
+        {
+            auto [ptr, ec] = std::from_chars(first, last, value, std::chars_format::general);
+            if (ec == std::errc::invalid_argument)
+            {
+                return nullptr;
+            }
+            if (ec == std::errc::result_out_of_range)
+            {
+                value = out_of_range_decimal(first, ptr);
+            }
+            value = negative ? -value : value;
+            return ptr;
+        }
+
+        if (special)
+        {
+            auto starts_with = [&](std::string_view word)
+            {
+                return std::size_t(last - first) >= word.size() && std::equal(word.begin(), word.end(), first, [](char a, char b)
+                                                                               { return a == std::tolower(b); });
+            };
+            if (starts_with("infinity"))
+            {
+                value = negative ? -INFINITY : INFINITY;
+                return first + 8;
+            }
+            if (starts_with("inf"))
+            {
+                value = negative ? -INFINITY : INFINITY;
+                return first + 3;
+            }
+            if (starts_with("nan"))
+            {
+                value = NAN;
+                return first + 3;
+            }
+        }
+        return nullptr;
+    }
+
+    // Parameters of the Two-Way string-matching algorithm for a pattern, computed once on demand.
+    // See: https://en.wikipedia.org/wiki/Two-way_string-matching_algorithm
+    struct TwoWay
+    {
+        // Critical position of the factorization, the pattern is split into [0, suffix) and [suffix, m).
+        std::size_t suffix = 0;
+
+        // Period of the right part, or a shift that is safe if the pattern is not periodic.
+        std::size_t period = 0;
+
+        // Whether the left part is a suffix of the period, so that the matched prefix can be remembered.
+        bool periodic = false;
+
+        // Whether the parameters have been computed.
+        bool ready = false;
+    };
+
+    // Return the start of the maximal suffix of `needle` and its period, in normal or reversed lexicographic order.
+    static std::size_t max_suffix(std::string_view needle, std::size_t& period, bool reversed)
+    {
+        std::size_t ms = std::size_t(-1), j = 0, k = 1, p = 1; // ms + k wraps around to k - 1
+        while (j + k < needle.size())
+        {
+            unsigned char a = needle[j + k], b = needle[ms + k];
+            if (reversed ? b < a : a < b)
+            {
+                j += k;
+                k = 1;
+                p = j - ms;
+            }
+            else if (a == b)
+            {
+                if (k != p)
+                {
+                    ++k;
+                }
+                else
+                {
+                    j += p;
+                    k = 1;
+                }
+            }
+            else
+            {
+                ms = j++;
+                k = p = 1;
+            }
+        }
+        period = p;
+        return ms + 1;
+    }
+
+    // Compute the critical factorization of `needle`. O(M)
+    static TwoWay two_way_prepare(std::string_view needle)
+    {
+        TwoWay tw;
+        std::size_t p1, p2;
+        std::size_t s1 = max_suffix(needle, p1, false), s2 = max_suffix(needle, p2, true);
+        tw.suffix = s1 > s2 ? s1 : s2;
+        tw.period = s1 > s2 ? p1 : p2;
+        tw.periodic = tw.suffix + tw.period <= needle.size() && needle.substr(0, tw.suffix) == needle.substr(tw.period, tw.suffix);
+        if (!tw.periodic)
+        {
+            tw.period = std::max(tw.suffix, needle.size() - tw.suffix) + 1;
+        }
+        tw.ready = true;
+        return tw;
+    }
+
+    // Find `needle` (length >= 2) in `hay` from `from` by the Two-Way algorithm. O(N) time and O(1) space
+    static std::size_t two_way_find(std::string_view hay, std::size_t from, std::string_view needle, const TwoWay& tw)
+    {
+        const std::size_t n = hay.size(), m = needle.size(), suffix = tw.suffix;
+        std::size_t memory = 0; // length of the prefix known to match after a shift by the period
+        for (std::size_t j = from; j + m <= n;)
+        {
+            // match the right part from left to right
+            std::size_t i = tw.periodic ? std::max(suffix, memory) : suffix;
+            while (i < m && needle[i] == hay[i + j])
+            {
+                ++i;
+            }
+            if (i < m)
+            {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+
+            // match the left part from right to left
+            std::size_t low = tw.periodic ? memory : 0;
+            i = suffix;
+            while (i > low && needle[i - 1] == hay[i - 1 + j])
+            {
+                --i;
+            }
+            if (i <= low)
+            {
+                return j;
+            }
+            j += tw.period;
+            memory = tw.periodic ? m - tw.period : 0;
+        }
+        return std::string_view::npos;
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi" // the AVX2 kernels are always inlined into PYINCPP_AVX2 functions, so no call crosses the ABI
+#endif
+    // Filter the positions from `i` whose first and last characters match `needle` (length >= 2) a vector at a time, and verify them.
+    // Return the position found, or npos when less than a vector remains or the verification work `wasted` exceeds the limit.
+    template <typename S>
+    PYINCPP_KERNEL static std::size_t search_kernel(std::string_view hay, std::size_t from, std::string_view needle, std::size_t& i, std::size_t& wasted)
+    {
+        const char* h = hay.data();
+        const std::size_t n = hay.size(), m = needle.size();
+        const typename S::vec first = S::set1(needle[0]), last = S::set1(needle[m - 1]);
+        for (; i + m - 1 + S::WIDTH <= n; i += S::WIDTH)
+        {
+            unsigned mask = S::movemask(S::bit_and(S::eq(S::load(h + i), first), S::eq(S::load(h + i + m - 1), last)));
+            for (; mask != 0; mask &= mask - 1)
+            {
+                std::size_t pos = i + std::countr_zero(mask);
+                if (std::memcmp(h + pos + 1, needle.data() + 1, m - 2) == 0)
+                {
+                    return pos;
+                }
+                wasted += m;
+            }
+            if (wasted > 2 * (i - from) + 1024)
+            {
+                break;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    PYINCPP_AVX2 static std::size_t search_avx2(std::string_view hay, std::size_t from, std::string_view needle, std::size_t& i, std::size_t& wasted)
+    {
+        return search_kernel<detail::Avx2>(hay, from, needle, i, wasted);
+    }
+
+    // Count the occurrences of a character in the vectors of [`first`, `last`), advance `first`.
+    template <typename S>
+    PYINCPP_KERNEL static int count_char_kernel(const char*& first, const char* last, char ch)
+    {
+        int cnt = 0;
+        const typename S::vec target = S::set1(ch);
+        for (; last - first >= S::WIDTH; first += S::WIDTH)
+        {
+            cnt += std::popcount(S::movemask(S::eq(S::load(first), target)));
+        }
+        return cnt;
+    }
+
+    PYINCPP_AVX2 static int count_char_avx2(const char*& first, const char* last, char ch)
+    {
+        return count_char_kernel<detail::Avx2>(first, last, ch);
+    }
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    // Find `needle` in `hay` from `from`, return npos if not found.
+    // Candidates are filtered by the first and the last characters of the needle, 32 or 16 positions at a time with SIMD.
+    // If the filter keeps producing false positives, switch to the Two-Way algorithm, so the worst case is linear.
+    static std::size_t search(std::string_view hay, std::size_t from, std::string_view needle, TwoWay& tw)
+    {
+        const std::size_t n = hay.size(), m = needle.size();
+        if (from > n || m > n - from)
+        {
+            return std::string_view::npos;
+        }
+        if (m == 0)
+        {
+            return from;
+        }
+
+        const char* h = hay.data();
+        if (m == 1)
+        {
+            auto p = static_cast<const char*>(std::memchr(h + from, needle[0], n - from));
+            return p ? p - h : std::string_view::npos;
+        }
+
+        // give up filtering if the verification work exceeds twice the scanned length plus a constant
+        std::size_t i = from, wasted = 0;
+        auto fallback = [&]()
+        {
+            if (!tw.ready)
+            {
+                tw = two_way_prepare(needle);
+            }
+            return two_way_find(hay, i, needle, tw);
+        };
+
+#if defined(__SSE2__) || defined(_M_X64)
+        std::size_t pos = detail::has_avx2() ? search_avx2(hay, from, needle, i, wasted) : search_kernel<detail::Sse2>(hay, from, needle, i, wasted);
+        if (pos != std::string_view::npos)
+        {
+            return pos;
+        }
+        if (wasted > 2 * (i - from) + 1024)
+        {
+            return fallback();
+        }
+#endif
+
+        // the rest (or all without SIMD): jump between the first characters by memchr
+        for (; i + m <= n; ++i)
+        {
+            auto p = static_cast<const char*>(std::memchr(h + i, needle[0], n - m + 1 - i));
+            if (!p)
+            {
+                break;
+            }
+            i = p - h;
+            if (h[i + m - 1] == needle[m - 1] && std::memcmp(h + i + 1, needle.data() + 1, m - 2) == 0)
+            {
+                return i;
+            }
+            if ((wasted += m) > 2 * (i - from) + 1024)
+            {
+                return fallback();
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    // Count the occurrences of a character, 32 or 16 characters at a time with SIMD.
+    static int count_char(std::string_view hay, char ch)
+    {
+        const char* first = hay.data();
+        const char* last = first + hay.size();
+        int cnt = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+        cnt = detail::has_avx2() ? count_char_avx2(first, last, ch) : count_char_kernel<detail::Sse2>(first, last, ch);
+#endif
+
+        return cnt + std::count(first, last, ch);
+    }
+
+    // ASCII character class of the whole-string predicates and strip.
+    enum class Ascii
+    {
+        DIGIT, // '0'-'9'
+        ALPHA, // 'A'-'Z', 'a'-'z'
+        ALNUM, // DIGIT or ALPHA
+        SPACE, // ' ', '\t', '\n', '\v', '\f', '\r'
+        ASCII, // 0x00-0x7F
+        BLANK, // 0x00-0x20, stripped by default
+        CHAR,  // the specified character
+    };
+
+    // Test whether the character `c` is in the class, `ch` is the character of Ascii::CHAR.
+    template <Ascii C>
+    static bool in_class(char c, char ch)
+    {
+        unsigned char u = c;
+        if constexpr (C == Ascii::DIGIT)
+        {
+            return unsigned(u - '0') <= 9;
+        }
+        else if constexpr (C == Ascii::ALPHA)
+        {
+            return unsigned((u | 0x20) - 'a') <= 25;
+        }
+        else if constexpr (C == Ascii::ALNUM)
+        {
+            return in_class<Ascii::DIGIT>(c, ch) || in_class<Ascii::ALPHA>(c, ch);
+        }
+        else if constexpr (C == Ascii::SPACE)
+        {
+            return u == ' ' || unsigned(u - '\t') <= 4;
+        }
+        else if constexpr (C == Ascii::ASCII)
+        {
+            return u <= 0x7F;
+        }
+        else if constexpr (C == Ascii::BLANK)
+        {
+            return u <= 0x20;
+        }
+        else
+        {
+            return c == ch;
+        }
+    }
+
+    // Case conversion of ASCII letters.
+    enum class Case
+    {
+        LOWER,
+        UPPER,
+        SWAP,
     };
 
-    // Used for FSM.
-    enum event
+#if defined(__SSE2__) || defined(_M_X64)
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi" // the AVX2 kernels are always inlined into PYINCPP_AVX2 functions, so no call crosses the ABI
+#endif
+    // Return the bit mask of the characters at `p` in the class, `ch` is the broadcast character of Ascii::CHAR.
+    template <typename S, Ascii C>
+    PYINCPP_KERNEL static unsigned class_mask(const char* p, const typename S::vec& ch)
+    {
+        typename S::vec v = S::load(p);
+        if constexpr (C == Ascii::DIGIT)
+        {
+            return S::movemask(S::below(S::sub(v, S::set1('0')), S::set1(9)));
+        }
+        else if constexpr (C == Ascii::ALPHA)
+        {
+            return S::movemask(S::below(S::sub(S::bit_or(v, S::set1(0x20)), S::set1('a')), S::set1(25)));
+        }
+        else if constexpr (C == Ascii::ALNUM)
+        {
+            return class_mask<S, Ascii::DIGIT>(p, ch) | class_mask<S, Ascii::ALPHA>(p, ch);
+        }
+        else if constexpr (C == Ascii::SPACE)
+        {
+            return S::movemask(S::bit_or(S::eq(v, S::set1(' ')), S::below(S::sub(v, S::set1('\t')), S::set1(4))));
+        }
+        else if constexpr (C == Ascii::ASCII)
+        {
+            return S::movemask(S::below(v, S::set1(0x7F)));
+        }
+        else if constexpr (C == Ascii::BLANK)
+        {
+            return S::movemask(S::below(v, S::set1(0x20)));
+        }
+        else
+        {
+            return S::movemask(S::eq(v, ch));
+        }
+    }
+
+    // Return the first character in [`first`, `last`) not in the class, or where less than a vector remains.
+    template <typename S, Ascii C>
+    PYINCPP_KERNEL static const char* skip_kernel(const char* first, const char* last, char ch)
+    {
+        const typename S::vec target = S::set1(ch);
+        for (; last - first >= S::WIDTH; first += S::WIDTH)
+        {
+            if (unsigned mask = class_mask<S, C>(first, target); mask != S::ALL)
+            {
+                return first + std::countr_one(mask);
+            }
+        }
+        return first;
+    }
+
+    template <Ascii C>
+    PYINCPP_AVX2 static const char* skip_avx2(const char* first, const char* last, char ch)
+    {
+        return skip_kernel<detail::Avx2, C>(first, last, ch);
+    }
+
+    // Return the character following the last character in [`first`, `last`) not in the class, or where less than a vector remains.
+    template <typename S, Ascii C>
+    PYINCPP_KERNEL static const char* skip_back_kernel(const char* first, const char* last, char ch)
+    {
+        const typename S::vec target = S::set1(ch);
+        for (; last - first >= S::WIDTH; last -= S::WIDTH)
+        {
+            if (unsigned mask = class_mask<S, C>(last - S::WIDTH, target); mask != S::ALL)
+            {
+                return last - S::WIDTH + std::bit_width(~mask & S::ALL);
+            }
+        }
+        return last;
+    }
+
+    template <Ascii C>
+    PYINCPP_AVX2 static const char* skip_back_avx2(const char* first, const char* last, char ch)
+    {
+        return skip_back_kernel<detail::Avx2, C>(first, last, ch);
+    }
+
+    // Convert the case of the ASCII letters of the vectors in [`first`, `last`) and write the result to `out`, advance both.
+    template <typename S, Case C>
+    PYINCPP_KERNEL static void convert_case_kernel(const char*& first, const char* last, char*& out)
+    {
+        // a letter of the case to convert only differs from the other case in bit 0x20
+        const char low = C == Case::UPPER ? 'a' : 'A';
+        for (; last - first >= S::WIDTH; first += S::WIDTH, out += S::WIDTH)
+        {
+            typename S::vec v = S::load(first);
+            typename S::vec letters = C == Case::SWAP ? S::below(S::sub(S::bit_or(v, S::set1(0x20)), S::set1('a')), S::set1(25))
+                                                      : S::below(S::sub(v, S::set1(low)), S::set1(25));
+            S::store(out, S::bit_xor(v, S::bit_and(letters, S::set1(0x20))));
+        }
+    }
+
+    template <Case C>
+    PYINCPP_AVX2 static void convert_case_avx2(const char*& first, const char* last, char*& out)
+    {
+        convert_case_kernel<detail::Avx2, C>(first, last, out);
+    }
+
+    // Count the UTF-8 continuation bytes 0x80-0xBF of the vectors in [`first`, `last`), advance `first`.
+    template <typename S>
+    PYINCPP_KERNEL static int count_continuations_kernel(const char*& first, const char* last)
+    {
+        int cnt = 0;
+        const typename S::vec lead = S::set1(char(0x80)), range = S::set1(0x3F);
+        for (; last - first >= S::WIDTH; first += S::WIDTH)
+        {
+            cnt += std::popcount(S::movemask(S::below(S::sub(S::load(first), lead), range)));
+        }
+        return cnt;
+    }
+
+    PYINCPP_AVX2 static int count_continuations_avx2(const char*& first, const char* last)
+    {
+        return count_continuations_kernel<detail::Avx2>(first, last);
+    }
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    // Return the first character in [`first`, `last`) not in the class, or `last`.
+    template <Ascii C>
+    static const char* skip(const char* first, const char* last, char ch = 0)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        first = detail::has_avx2() ? skip_avx2<C>(first, last, ch) : skip_kernel<detail::Sse2, C>(first, last, ch);
+#endif
+        while (first != last && in_class<C>(*first, ch))
+        {
+            ++first;
+        }
+        return first;
+    }
+
+    // Return the character following the last character in [`first`, `last`) not in the class, or `first`.
+    template <Ascii C>
+    static const char* skip_back(const char* first, const char* last, char ch = 0)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        last = detail::has_avx2() ? skip_back_avx2<C>(first, last, ch) : skip_back_kernel<detail::Sse2, C>(first, last, ch);
+#endif
+        while (last != first && in_class<C>(last[-1], ch))
+        {
+            --last;
+        }
+        return last;
+    }
+
+    // Test whether all the characters are in the class.
+    template <Ascii C>
+    bool all_in_class() const
+    {
+        return skip<C>(str_.data(), str_.data() + str_.size()) == str_.data() + str_.size();
+    }
+
+    // Convert the case of the ASCII letters in [`first`, `last`) and write the result to `out`.
+    template <Case C>
+    static void convert_case(const char* first, const char* last, char* out)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        if (detail::has_avx2())
+        {
+            convert_case_avx2<C>(first, last, out);
+        }
+        else
+        {
+            convert_case_kernel<detail::Sse2, C>(first, last, out);
+        }
+#endif
+        // a letter of the case to convert only differs from the other case in bit 0x20
+        const char low = C == Case::UPPER ? 'a' : 'A';
+        for (; first != last; ++first, ++out)
+        {
+            bool letter = C == Case::SWAP ? in_class<Ascii::ALPHA>(*first, 0) : unsigned(static_cast<unsigned char>(*first) - low) <= 25;
+            *out = letter ? *first ^ 0x20 : *first;
+        }
+    }
+
+    // Return the number of bytes of the valid UTF-8 sequence at the beginning of [`first`, `last`), or 0 if it is invalid.
+    // Overlong encodings, surrogates and code points above U+10FFFF are invalid, like Python's decoder.
+    static int utf8_length(const char* first, const char* last)
+    {
+        auto byte = [&](int i)
+        { return static_cast<unsigned char>(first[i]); };
+        auto continuation = [&](int i, unsigned lo = 0x80, unsigned hi = 0xBF)
+        { return i < last - first && byte(i) >= lo && byte(i) <= hi; };
+
+        unsigned lead = byte(0);
+        if (lead < 0x80)
+        {
+            return 1;
+        }
+        if (lead < 0xC2)
+        {
+            return 0;
+        }
+        if (lead < 0xE0)
+        {
+            return continuation(1) ? 2 : 0;
+        }
+        if (lead < 0xF0)
+        {
+            bool second = lead == 0xE0 ? continuation(1, 0xA0) : lead == 0xED ? continuation(1, 0x80, 0x9F) : continuation(1);
+            return second && continuation(2) ? 3 : 0;
+        }
+        if (lead < 0xF5)
+        {
+            bool second = lead == 0xF0 ? continuation(1, 0x90) : lead == 0xF4 ? continuation(1, 0x80, 0x8F) : continuation(1);
+            return second && continuation(2) && continuation(3) ? 4 : 0;
+        }
+        return 0;
+    }
+
+    // Return the number of bytes of the UTF-8 sequence led by the byte, require valid UTF-8.
+    static int utf8_sequence_length(char lead)
+    {
+        unsigned char u = lead;
+        return u < 0x80 ? 1 : u < 0xE0 ? 2 : u < 0xF0 ? 3 : 4;
+    }
+
+    // Decode the code point of the UTF-8 sequence of `len` bytes at `p`, require valid UTF-8.
+    static char32_t utf8_decode(const char* p, int len)
+    {
+        static constexpr unsigned char LEAD_MASKS[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+        char32_t cp = static_cast<unsigned char>(p[0]) & LEAD_MASKS[len];
+        for (int i = 1; i < len; ++i)
+        {
+            cp = (cp << 6) | (static_cast<unsigned char>(p[i]) & 0x3F);
+        }
+        return cp;
+    }
+
+    // Append the UTF-8 encoding of the code point to `out`.
+    static void utf8_encode(std::string& out, char32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            out += char(cp);
+        }
+        else if (cp < 0x800)
+        {
+            out += char(0xC0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            out += char(0xE0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            out += char(0xF0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3F));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Count the code points in [`first`, `last`) of valid UTF-8, that is the bytes other than continuation bytes 0x80-0xBF.
+    static int count_code_points(const char* first, const char* last)
+    {
+        int cnt = last - first;
+#if defined(__SSE2__) || defined(_M_X64)
+        cnt -= detail::has_avx2() ? count_continuations_avx2(first, last) : count_continuations_kernel<detail::Sse2>(first, last);
+#endif
+        return cnt - std::count_if(first, last, [](char c)
+                                   { return (static_cast<unsigned char>(c) & 0xC0) == 0x80; });
+    }
+
+    // Map the code point to lowercase, for the letters of ASCII, Latin-1, Latin Extended-A, Greek and Cyrillic.
+    static char32_t lower_code_point(char32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            return cp - 'A' <= 25 ? cp | 0x20 : cp;
+        }
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7)
+        {
+            return cp + 0x20;
+        }
+        if (cp >= 0x100 && cp <= 0x17E)
+        {
+            if (cp == 0x178)
+            {
+                return 0xFF;
+            }
+            bool even_upper = cp <= 0x12F || (cp >= 0x132 && cp <= 0x137) || (cp >= 0x14A && cp <= 0x177);
+            bool odd_upper = (cp >= 0x139 && cp <= 0x148) || cp >= 0x179;
+            return (even_upper && cp % 2 == 0) || (odd_upper && cp % 2 == 1) ? cp + 1 : cp;
+        }
+        if (cp >= 0x386 && cp <= 0x3AB)
+        {
+            switch (cp)
+            {
+                case 0x386:
+                    return 0x3AC;
+                case 0x388:
+                case 0x389:
+                case 0x38A:
+                    return cp + 0x25;
+                case 0x38C:
+                    return 0x3CC;
+                case 0x38E:
+                case 0x38F:
+                    return cp + 0x3F;
+                default:
+                    return cp >= 0x391 && cp != 0x3A2 ? cp + 0x20 : cp;
+            }
+        }
+        if (cp >= 0x400 && cp <= 0x42F)
+        {
+            return cp < 0x410 ? cp + 0x50 : cp + 0x20;
+        }
+        return cp;
+    }
+
+    // Map the code point to uppercase, for the letters of ASCII, Latin-1, Latin Extended-A, Greek and Cyrillic.
+    // The mapping of 'ß' to "SS" changes the length, so it is handled by the caller.
+    static char32_t upper_code_point(char32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            return cp - 'a' <= 25 ? cp & ~0x20u : cp;
+        }
+        if (cp >= 0xE0 && cp <= 0xFE && cp != 0xF7)
+        {
+            return cp - 0x20;
+        }
+        if (cp == 0xB5)
+        {
+            return 0x39C; // micro sign to Greek capital mu
+        }
+        if (cp == 0xFF)
+        {
+            return 0x178;
+        }
+        if (cp >= 0x101 && cp <= 0x17F)
+        {
+            if (cp == 0x131)
+            {
+                return 'I';
+            }
+            if (cp == 0x17F)
+            {
+                return 'S';
+            }
+            bool odd_lower = cp <= 0x12F || (cp >= 0x133 && cp <= 0x137) || (cp >= 0x14B && cp <= 0x177);
+            bool even_lower = (cp >= 0x13A && cp <= 0x148) || cp >= 0x17A;
+            return (odd_lower && cp % 2 == 1) || (even_lower && cp % 2 == 0) ? cp - 1 : cp;
+        }
+        if (cp >= 0x3AC && cp <= 0x3CE)
+        {
+            switch (cp)
+            {
+                case 0x3AC:
+                    return 0x386;
+                case 0x3AD:
+                case 0x3AE:
+                case 0x3AF:
+                    return cp - 0x25;
+                case 0x3C2:
+                    return 0x3A3; // final sigma
+                case 0x3CC:
+                    return 0x38C;
+                case 0x3CD:
+                case 0x3CE:
+                    return cp - 0x3F;
+                default:
+                    return cp >= 0x3B1 && cp <= 0x3CB ? cp - 0x20 : cp;
+            }
+        }
+        if (cp >= 0x430 && cp <= 0x45F)
+        {
+            return cp < 0x450 ? cp - 0x20 : cp - 0x50;
+        }
+        return cp;
+    }
+
+    // Test whether the code point is a letter with case, see `lower_code_point`.
+    static bool is_cased(char32_t cp)
+    {
+        return lower_code_point(cp) != cp || upper_code_point(cp) != cp || cp == 0xDF || cp == 0x130;
+    }
+
+    // Find `needle` in [`start`, `stop`) of this, require start <= size.
+    int find_in(std::string_view needle, TwoWay& tw, int start, int stop) const
+    {
+        stop = stop > size() ? size() : stop;
+        if (stop < start)
+        {
+            return -1;
+        }
+
+        auto pos = search(str_.substr(0, stop), start, needle, tw);
+        return pos == std::string_view::npos ? -1 : int(pos);
+    }
+
+    // Count the non-overlapping occurrences of `needle` in this.
+    int count_in(std::string_view needle, TwoWay& tw) const
+    {
+        if (needle.empty())
+        {
+            return size() + 1;
+        }
+        if (needle.size() == 1)
+        {
+            return count_char(str_, needle[0]);
+        }
+
+        int cnt = 0;
+        for (std::size_t pos = 0; (pos = search(str_, pos, needle, tw)) != std::string_view::npos; pos += needle.size())
+        {
+            ++cnt;
+        }
+        return cnt;
+    }
+
+public:
+    /// Pattern precompiled for searching, so that it can be applied to many strings without preprocessing again.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView::Pattern error("ERROR");
+    /// for (StrView line : log.splitlines_view()) { if (line.contains(error)) {} }
+    /// ```
+    class Pattern
+    {
+    private:
+        // Characters of the pattern.
+        std::string needle_;
+
+        // Two-Way parameters of the pattern.
+        TwoWay two_way_;
+
+        friend class StrView;
+
+    public:
+        /// Compile the pattern. O(M)
+        explicit Pattern(StrView pattern)
+            : needle_(pattern.str_)
+            , two_way_(needle_.size() >= 2 ? two_way_prepare(needle_) : TwoWay{})
+        {
+        }
+
+        /// Return the number of characters of the pattern.
+        int size() const
+        {
+            return needle_.size();
+        }
+    };
+
+    /// Set of patterns compiled into an Aho-Corasick automaton, so that all of them are searched in one pass over a string.
+    /// The automaton can be applied to many strings without preprocessing again.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView::PatternSet keywords({"he", "she", "his", "hers"});
+    /// StrView("ushers").find_any(keywords); // {1, 1} ("she" at 1)
+    /// StrView("ushers").count_many(keywords); // [1, 1, 0, 1]
+    /// ```
+    class PatternSet
+    {
+    private:
+        // Characters of the patterns.
+        std::vector<std::string> patterns_;
+
+        // Index of the first pattern equal to each pattern, so that duplicates share one state.
+        std::vector<int> canonical_;
+
+        // Equivalence class of each byte, 0 for the bytes that appear in no pattern.
+        std::array<unsigned char, 256> class_of_{};
+
+        // Number of byte classes, the width of a row of the transition table.
+        int classes_ = 1;
+
+        // Dense transition table of the automaton, `delta_[state * classes_ + class]` is the next state.
+        // The failure links are folded in, so every byte costs exactly one lookup.
+        std::vector<int> delta_;
+
+        // Length of the longest pattern prefix that each state represents.
+        std::vector<int> depth_;
+
+        // Pattern spelled by each state, or -1.
+        std::vector<int> word_;
+
+        // Longest pattern that is a suffix of each state, or -1.
+        std::vector<int> longest_;
+
+        // Nearest proper suffix state that spells a pattern, or 0 if none.
+        std::vector<int> output_;
+
+        friend class StrView;
+        friend class Str;
+
+        // Build the automaton. O(M * classes) where M is the total length of the patterns.
+        void compile()
+        {
+            for (const auto& pattern : patterns_)
+            {
+                if (pattern.empty())
+                {
+                    throw std::runtime_error("Error: Empty pattern.");
+                }
+                for (unsigned char ch : pattern)
+                {
+                    if (class_of_[ch] == 0)
+                    {
+                        class_of_[ch] = classes_++;
+                    }
+                }
+            }
+
+            // trie, the missing transitions are -1
+            delta_.assign(classes_, -1);
+            depth_.assign(1, 0);
+            word_.assign(1, -1);
+            for (int i = 0; i < int(patterns_.size()); ++i)
+            {
+                int state = 0;
+                for (unsigned char ch : patterns_[i])
+                {
+                    int& next = delta_[state * classes_ + class_of_[ch]];
+                    if (next == -1)
+                    {
+                        next = depth_.size();
+                        delta_.resize(delta_.size() + classes_, -1);
+                        depth_.push_back(depth_[state] + 1);
+                        word_.push_back(-1);
+                    }
+                    state = delta_[state * classes_ + class_of_[ch]]; // `next` may be invalidated by resize
+                }
+                if (word_[state] == -1)
+                {
+                    word_[state] = i;
+                }
+                canonical_.push_back(word_[state]);
+            }
+
+            // fill the missing transitions with the ones of the failure state, in breadth-first order
+            const int states = depth_.size();
+            std::vector<int> fail(states, 0);
+            longest_.assign(states, -1);
+            output_.assign(states, 0);
+            std::vector<int> queue;
+            queue.reserve(states);
+            queue.push_back(0);
+            for (std::size_t head = 0; head < queue.size(); ++head)
+            {
+                const int state = queue[head];
+                const int* fail_row = &delta_[fail[state] * classes_];
+                for (int c = 0; c < classes_; ++c)
+                {
+                    int& next = delta_[state * classes_ + c];
+                    if (next == -1)
+                    {
+                        next = state == 0 ? 0 : fail_row[c];
+                        continue;
+                    }
+
+                    fail[next] = state == 0 ? 0 : fail_row[c];
+                    output_[next] = word_[fail[next]] != -1 ? fail[next] : output_[fail[next]];
+                    longest_[next] = word_[next] != -1 ? word_[next] : longest_[fail[next]];
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        // Return the leftmost-longest match {start, pattern} in `text` starting from `from`, or {-1, -1}.
+        std::pair<int, int> search(std::string_view text, int from) const
+        {
+            int best_start = -1, best = -1;
+            int state = 0;
+            for (int i = from; i < int(text.size()); ++i)
+            {
+                state = delta_[state * classes_ + class_of_[static_cast<unsigned char>(text[i])]];
+
+                // no match can start at or before `best_start` anymore
+                if (best != -1 && i + 1 - depth_[state] > best_start)
+                {
+                    break;
+                }
+
+                if (int p = longest_[state]; p != -1)
+                {
+                    int start = i + 1 - int(patterns_[p].size());
+                    if (best == -1 || start <= best_start) // leftmost, then longest since it ends later
+                    {
+                        best_start = start;
+                        best = p;
+                    }
+                }
+            }
+            return {best_start, best};
+        }
+
+    public:
+        /// Compile the patterns. Require all patterns to be non-empty.
+        PatternSet(const std::initializer_list<StrView>& patterns)
+        {
+            for (const auto& pattern : patterns)
+            {
+                patterns_.emplace_back(pattern.str_);
+            }
+            compile();
+        }
+
+        /// Compile the patterns from a range of strings. Require all patterns to be non-empty.
+        template <std::ranges::input_range R>
+        explicit PatternSet(const R& patterns)
+        {
+            for (const auto& pattern : patterns)
+            {
+                patterns_.emplace_back(StrView(pattern).str_);
+            }
+            compile();
+        }
+
+        /// Return the number of patterns.
+        int size() const
+        {
+            return patterns_.size();
+        }
+    };
+
+    /// Lazy forward range of the pieces of a view split by a separator, or split into lines.
+    /// Each piece is a `StrView` into the original characters, found only when the iterator advances.
+    /// The iterators refer to the range, so the range must outlive them.
+    class SplitRange
+    {
+    private:
+        // Characters to split.
+        std::string_view str_;
+
+        // Separator, owned so that a temporary separator is allowed. Empty means splitting into lines.
+        std::string sep_;
+
+        // Whether to retain empty pieces.
+        bool keep_empty_;
+
+    public:
+        /// Forward iterator over the pieces.
+        class Iterator
+        {
+        private:
+            // The range, null for the end.
+            const SplitRange* range_ = nullptr;
+
+            // Characters not split yet.
+            std::string_view rest_;
+
+            // Whether the last piece has been taken from rest_.
+            bool last_ = false;
+
+            // Current piece.
+            std::string_view piece_;
+
+            // Take the next piece from rest_, or become the end.
+            void advance()
+            {
+                const std::string_view sep = range_->sep_;
+                do
+                {
+                    if (last_ || (sep.empty() && rest_.empty())) // no trailing empty line
+                    {
+                        range_ = nullptr;
+                        return;
+                    }
+
+                    std::size_t pos = sep.empty() ? rest_.find_first_of("\r\n") : rest_.find(sep);
+                    if (pos == std::string_view::npos)
+                    {
+                        piece_ = rest_;
+                        last_ = true;
+                    }
+                    else
+                    {
+                        std::size_t len = !sep.empty() ? sep.size() : rest_.substr(pos, 2) == "\r\n" ? 2 : 1;
+                        piece_ = rest_.substr(0, pos);
+                        rest_ = rest_.substr(pos + len);
+                    }
+                } while (!range_->keep_empty_ && piece_.empty());
+            }
+
+            friend class SplitRange;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = StrView;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            StrView operator*() const
+            {
+                return piece_;
+            }
+
+            Iterator& operator++()
+            {
+                advance();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator it = *this;
+                advance();
+                return it;
+            }
+
+            bool operator==(const Iterator& that) const
+            {
+                return range_ == that.range_ && (!range_ || piece_.data() == that.piece_.data());
+            }
+        };
+
+        SplitRange(std::string_view str, std::string_view sep, bool keep_empty)
+            : str_(str)
+            , sep_(sep)
+            , keep_empty_(keep_empty)
+        {
+        }
+
+        Iterator begin() const
+        {
+            Iterator it;
+            it.range_ = this;
+            it.rest_ = str_;
+            it.advance();
+            return it;
+        }
+
+        Iterator end() const
+        {
+            return Iterator();
+        }
+    };
+
+    /*
+     * Constructor
+     */
+
+    /// Create an empty view.
+    StrView() = default;
+
+    /// Create a view of null-terminated characters.
+    StrView(const char* chars)
+        : str_(chars)
+    {
+    }
+
+    /// Create a view of std::string_view.
+    StrView(std::string_view view)
+        : str_(view)
+    {
+    }
+
+    /// Create a view of std::string.
+    StrView(const std::string& string)
+        : str_(string)
+    {
+    }
+
+    /*
+     * Comparison
+     */
+
+    /// Compare the view with another view.
+    auto operator<=>(const StrView& that) const = default;
+
+    /*
+     * Iterator
+     */
+
+    /// Return an iterator to the first char of the view.
+    auto begin() const
+    {
+        return str_.cbegin();
+    }
+
+    /// Return an iterator to the char following the last char of the view.
+    auto end() const
+    {
+        return str_.cend();
+    }
+
+    /// Return a reverse iterator to the first char of the reversed view.
+    auto rbegin() const
+    {
+        return str_.crbegin();
+    }
+
+    /// Return a reverse iterator to the char following the last char of the reversed view.
+    auto rend() const
+    {
+        return str_.crend();
+    }
+
+    /*
+     * Access
+     */
+
+    /// Return the const reference to element at the specified position in the view.
+    /// Index can be negative, like Python's string: view[-1] gets the last element.
+    const char& operator[](int index) const
+    {
+        detail::check_bounds(index, -size(), size());
+
+        return str_[index >= 0 ? index : index + size()];
+    }
+
+    /*
+     * Examination
+     */
+
+    /// Return the number of elements in the view.
+    int size() const
+    {
+        return str_.size();
+    }
+
+    /// Return true if the view contains no elements.
+    bool is_empty() const
+    {
+        return str_.empty();
+    }
+
+    /// Return const pointer to the viewed characters, not null-terminated.
+    const char* data() const
+    {
+        return str_.data();
+    }
+
+    /// Return the viewed characters as std::string_view.
+    std::string_view view() const
+    {
+        return str_;
+    }
+
+    /// Return the index of the first occurrence of the specified pattern in the specified range [`start`, `stop`).
+    /// Or -1 if the view does not contain the pattern (in the specified range).
+    int find(StrView pattern, int start = 0, int stop = INT_MAX) const
+    {
+        if (start > size())
+        {
+            return -1;
+        }
+
+        TwoWay tw; // computed only if needed
+        return find_in(pattern.str_, tw, start, stop);
+    }
+
+    /// Return the index of the first occurrence of the precompiled pattern in the specified range [`start`, `stop`).
+    /// Or -1 if the view does not contain the pattern (in the specified range).
+    int find(const Pattern& pattern, int start = 0, int stop = INT_MAX) const
+    {
+        if (start > size())
+        {
+            return -1;
+        }
+
+        TwoWay tw = pattern.two_way_;
+        return find_in(pattern.needle_, tw, start, stop);
+    }
+
+    /// Return `true` if the view contains the specified `pattern` in the specified range [`start`, `stop`).
+    bool contains(StrView pattern, int start = 0, int stop = INT_MAX) const
+    {
+        return find(pattern, start, stop) != -1;
+    }
+
+    /// Return `true` if the view contains the precompiled `pattern` in the specified range [`start`, `stop`).
+    bool contains(const Pattern& pattern, int start = 0, int stop = INT_MAX) const
+    {
+        return find(pattern, start, stop) != -1;
+    }
+
+    /// Count the total number of occurrences of the specified `pattern` in the view.
+    int count(StrView pattern) const
+    {
+        TwoWay tw; // computed only if needed, then shared by all searches
+        return count_in(pattern.str_, tw);
+    }
+
+    /// Count the total number of occurrences of the precompiled `pattern` in the view.
+    int count(const Pattern& pattern) const
+    {
+        TwoWay tw = pattern.two_way_;
+        return count_in(pattern.needle_, tw);
+    }
+
+    /// Return the leftmost occurrence of any of the `patterns` starting from `start` as {index, pattern index},
+    /// preferring the longest pattern if several start at the same index. Or {-1, -1} if none occurs.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView("abcd").find_any({"bcd", "ab", "abc"}); // {0, 2}
+    /// ```
+    std::pair<int, int> find_any(const PatternSet& patterns, int start = 0) const
+    {
+        if (start > size())
+        {
+            return {-1, -1};
+        }
+
+        return patterns.search(str_, std::max(start, 0));
+    }
+
+    /// Count the non-overlapping occurrences of each of the `patterns` in the view in one pass.
+    /// The result is the same as calling `count` with each pattern in turn.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView("aaaa").count_many({"a", "aa", "b"}); // [4, 2, 0]
+    /// ```
+    List<int> count_many(const PatternSet& patterns) const
+    {
+        std::vector<int> counts(patterns.size(), 0);
+        std::vector<int> last_end(patterns.size(), 0); // end of the last counted occurrence of each pattern
+
+        int state = 0;
+        for (int i = 0; i < size(); ++i)
+        {
+            state = patterns.delta_[state * patterns.classes_ + patterns.class_of_[static_cast<unsigned char>(str_[i])]];
+
+            // all the patterns that end here, from the longest to the shortest
+            for (int s = patterns.word_[state] != -1 ? state : patterns.output_[state]; s != 0; s = patterns.output_[s])
+            {
+                int p = patterns.word_[s];
+                if (i + 1 - patterns.depth_[s] >= last_end[p])
+                {
+                    ++counts[p];
+                    last_end[p] = i + 1;
+                }
+            }
+        }
+
+        for (int i = 0; i < patterns.size(); ++i)
+        {
+            counts[i] = counts[patterns.canonical_[i]];
+        }
+        return counts;
+    }
+
+    /// Convert the view to a double-precision floating-point decimal number.
+    ///
+    /// If the view is too big to be representable will return `HUGE_VAL`.
+    /// If the view represents NaN will return `NAN`.
+    /// If the view represents Infinity will return `(+-)INFINITY`.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView("233.33").to_decimal(); // 233.33
+    /// StrView("123.456e-3").to_decimal(); // 0.123456
+    /// StrView("1e+600").to_decimal(); // HUGE_VAL
+    /// StrView("nan").to_decimal(); // NAN
+    /// StrView("inf").to_decimal(); // INFINITY
+    /// ```
+    double to_decimal() const
+    {
+        const char* first = str_.data();
+        const char* last = str_.data() + str_.size();
+        while (first != last && is_blank(*first))
+        {
+            ++first;
+        }
+        while (first != last && is_blank(last[-1]))
+        {
+            --last;
+        }
+
+        // infinity and nan are not surrounded by blanks
+        double value = 0;
+        if (scan_decimal(first, last, value, first == str_.data() && last == str_.data() + str_.size()) != last)
+        {
+            throw std::runtime_error("Error: Invalid literal for to_decimal().");
+        }
+        return value;
+    }
+
+    /// Convert a column of decimal numbers in the view to a list in one pass, without copying the characters.
+    ///
+    /// The numbers are separated by blank characters by default, or by `sep` with optional blanks around.
+    /// Each number has the same syntax as `to_decimal`.
+    ///
+    /// ### Example
+    /// ```
+    /// StrView("1.5\n-2\n3e2\n").to_decimals(); // [1.5, -2, 300]
+    /// StrView("1.5, -2, 3e2").to_decimals(','); // [1.5, -2, 300]
+    /// ```
+    List<double> to_decimals(std::optional<char> sep = std::nullopt) const
+    {
+        std::vector<double> values;
+        values.reserve(count_char(str_, sep.value_or('\n')) + 1); // exact with `sep`, one number per line otherwise
+        auto skip_blanks = [&](const char* p, const char* last)
+        {
+            while (p != last && is_blank(*p) && !(sep && *p == *sep))
+            {
+                ++p;
+            }
+            return p;
+        };
+
+        const char* last = str_.data() + str_.size();
+        for (const char* p = skip_blanks(str_.data(), last); p != last;)
+        {
+            // the number ends at a blank, `sep` or the end
+            double value = 0;
+            const char* end = scan_decimal(p, last, value, true);
+            if (!end)
+            {
+                throw std::runtime_error("Error: Invalid literal for to_decimals().");
+            }
+            p = skip_blanks(end, last);
+            if (p != last && (sep ? *p != *sep : p == end))
+            {
+                throw std::runtime_error("Error: Invalid literal for to_decimals().");
+            }
+            values.push_back(value);
+
+            if (sep && p != last && (p = skip_blanks(p + 1, last)) == last) // a number is required after `sep`
+            {
+                throw std::runtime_error("Error: Invalid literal for to_decimals().");
+            }
+        }
+        return values;
+    }
+
+    /// Convert the view to an `Int` based on 2-36 `base`.
+    ///
+    /// Numeric character in 36 base: 0, 1, ..., 9, A(10), ..., F(15), G(16), ..., Y(34), Z(35).
+    ///
+    /// ### Example
+    /// ```
+    /// StrView("233").to_integer(); // 233
+    /// StrView("cafebabe").to_integer(16); // 3405691582
+    /// StrView("z").to_integer(36); // 35
+    /// StrView("ffffffffffffffff").to_integer(16); // 18446744073709551615
+    /// ```
+    Int to_integer(int base = 10) const
+    {
+        // check base
+        if (base < 2 || base > 36)
+        {
+            throw std::runtime_error("Error: Invalid base for to_integer().");
+        }
+
+        const char* first = str_.data();
+        const char* last = str_.data() + str_.size();
+        while (first != last && is_blank(*first))
+        {
+            ++first;
+        }
+        while (first != last && is_blank(last[-1]))
+        {
+            --last;
+        }
+        const bool negative = first != last && *first == '-';
+        first += first != last && (*first == '+' || *first == '-');
+
+        // digits are validated and accumulated by chunks in Int::from_chars, which would accept a second '-'
+        Int integer;
+        if (first == last || *first == '-' || Int::from_chars(first, last, integer, base).ptr != last)
+        {
+            throw std::runtime_error("Error: Invalid literal for to_integer().");
+        }
+
+        return negative ? -integer : integer;
+    }
+
+    /// Return `true` if the view begins with the specified string, otherwise return `false`.
+    bool starts_with(StrView str) const
+    {
+        return str_.starts_with(str.str_);
+    }
+
+    /// Return `true` if the view ends with the specified string, otherwise return `false`.
+    bool ends_with(StrView str) const
+    {
+        return str_.ends_with(str.str_);
+    }
+
+    /// Return `true` if the view is not empty and all the characters are ASCII digits, like `bytes.isdigit()` in Python.
+    bool is_digit() const
+    {
+        return !str_.empty() && all_in_class<Ascii::DIGIT>();
+    }
+
+    /// Return `true` if the view is not empty and all the characters are ASCII letters, like `bytes.isalpha()` in Python.
+    bool is_alpha() const
+    {
+        return !str_.empty() && all_in_class<Ascii::ALPHA>();
+    }
+
+    /// Return `true` if the view is not empty and all the characters are ASCII letters or digits, like `bytes.isalnum()` in Python.
+    bool is_alnum() const
+    {
+        return !str_.empty() && all_in_class<Ascii::ALNUM>();
+    }
+
+    /// Return `true` if the view is not empty and all the characters are ASCII whitespace " \t\n\v\f\r", like `bytes.isspace()` in Python.
+    bool is_space() const
+    {
+        return !str_.empty() && all_in_class<Ascii::SPACE>();
+    }
+
+    /// Return `true` if the view is empty or all the characters are ASCII, like `str.isascii()` in Python.
+    bool is_ascii() const
+    {
+        return all_in_class<Ascii::ASCII>();
+    }
+
+    /// Return `true` if the view is valid UTF-8. ASCII runs are checked 32 or 16 bytes at a time with SIMD.
+    bool is_utf8() const
+    {
+        const char* first = str_.data();
+        const char* last = first + str_.size();
+        while ((first = skip<Ascii::ASCII>(first, last)) != last)
+        {
+            int len = utf8_length(first, last);
+            if (len == 0)
+            {
+                return false;
+            }
+            first += len;
+        }
+        return true;
+    }
+
+    /// Return the number of code points of the view of valid UTF-8, like `len()` of `str` in Python.
+    int utf8_size() const
+    {
+        return count_code_points(str_.data(), str_.data() + str_.size());
+    }
+
+    /*
+     * Production
+     */
+
+    /// Return the view of the range [`start`, `stop`) without copy.
+    /// Index can be negative, like Python's string.
+    StrView slice(int start, int stop) const
+    {
+        detail::check_bounds(start, -size(), size() + 1);
+        detail::check_bounds(stop, -size() - 1, size() + 1);
+
+        start = start < 0 ? start + size() : start;
+        stop = stop < 0 ? stop + size() : stop;
+
+        return start < stop ? str_.substr(start, stop - start) : std::string_view();
+    }
+
+    /// Return the view without leading and trailing characters (default is blank character), without copy.
+    StrView strip(std::optional<char> ch = std::nullopt) const
+    {
+        return lstrip(ch).rstrip(ch);
+    }
+
+    /// Return the view without leading characters (default is blank character), without copy.
+    StrView lstrip(std::optional<char> ch = std::nullopt) const
+    {
+        const char* last = str_.data() + str_.size();
+        const char* first = ch ? skip<Ascii::CHAR>(str_.data(), last, *ch) : skip<Ascii::BLANK>(str_.data(), last);
+        return std::string_view(first, last - first);
+    }
+
+    /// Return the view without trailing characters (default is blank character), without copy.
+    StrView rstrip(std::optional<char> ch = std::nullopt) const
+    {
+        const char* first = str_.data();
+        const char* last = ch ? skip_back<Ascii::CHAR>(first, first + str_.size(), *ch) : skip_back<Ascii::BLANK>(first, first + str_.size());
+        return std::string_view(first, last - first);
+    }
+
+    /// Split the view with separator (default = " ") lazily, like `Str::split()` but without copy.
+    /// If `keep_empty` is set (default = false), empty pieces will be retained.
+    ///
+    /// ### Example
+    /// ```
+    /// for (StrView token : StrView("one, two, three").split_view(", ")) {} // "one", "two", "three"
+    /// ```
+    SplitRange split_view(StrView sep = " ", bool keep_empty = false) const
+    {
+        if (sep.is_empty())
+        {
+            throw std::runtime_error("Error: Empty separator.");
+        }
+
+        return SplitRange(str_, sep.str_, keep_empty);
+    }
+
+    /// Split the view into lines lazily at "\n", "\r\n" or "\r", like `str.splitlines()` in Python but without copy.
+    ///
+    /// ### Example
+    /// ```
+    /// for (StrView line : StrView("a\r\n\nb\n").splitlines_view()) {} // "a", "", "b"
+    /// ```
+    SplitRange splitlines_view() const
+    {
+        return SplitRange(str_, {}, true);
+    }
+
+    /*
+     * Print / Input
+     */
+
+    /// Output the view to the specified output stream.
+    friend std::ostream& operator<<(std::ostream& os, const StrView& view)
+    {
+        return os << '"' << view.str_ << '"';
+    }
+
+    friend class Str;
+};
+
+/// Str is immutable sequence of characters.
+///
+/// Short strings are stored inline, and long strings in a reference-counted buffer,
+/// so copies, slices with step 1, `strip` and `split` pieces share the characters in O(1), see `compact`.
+class Str
+{
+private:
+    // Maximum number of characters stored inline, without a shared buffer.
+    static constexpr int SMALL_SIZE = 15;
+
+    // A short string stores its characters inline, a long string shares an immutable buffer, told apart by `size_`.
+    union
+    {
+        // Characters of a short string, null-terminated.
+        char small_[SMALL_SIZE + 1] = {};
+
+        // Immutable characters shared between copies and substrings of a long string.
+        std::shared_ptr<const std::string> buffer_;
+    };
+
+    // Sparse index from code points to bytes of a UTF-8 string.
+    struct Utf8Index
+    {
+        // Code points between two recorded offsets.
+        static constexpr int STRIDE = 64;
+
+        // Number of code points, -1 for an ASCII string whose code points are its bytes.
+        int size = -1;
+
+        // Byte offset of every STRIDE-th code point.
+        std::vector<int> offsets;
+    };
+
+    // Rarely used state, which depends only on the characters, so it is shared by copies.
+    struct Extra
+    {
+        // Number of strings sharing this state.
+        std::atomic<int> refs = 1;
+
+        // Cached hash of the string, 0 if not computed yet.
+        std::atomic<std::size_t> hash = 0;
+
+        // Characters in the intern pool equal to this string, null if the string is not interned. Set before sharing,
+        // and the entry is erased from the pool with the last state that refers to it.
+        const std::string* interned = nullptr;
+
+        // Index of code points built on the first access by code point.
+        std::atomic<const Utf8Index*> utf8 = nullptr;
+
+        // Null-terminated copy of the characters built by `c_str` for a substring in the middle of its buffer.
+        std::atomic<const std::string*> terminated = nullptr;
+
+        ~Extra()
+        {
+            release(utf8.load(std::memory_order_acquire));
+            delete terminated.load(std::memory_order_acquire);
+            if (interned)
+            {
+                InternPool& pool = intern_pool();
+                std::lock_guard lock(pool.mutex);
+                auto it = pool.entries.find(*interned);
+                if (--it->second == 0)
+                {
+                    pool.entries.erase(it);
+                }
+            }
+        }
+    };
+
+    // Pool of interned characters, counting the states that refer to each entry.
+    struct InternPool
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, int> entries; // nodes are never moved, so the pointers to the keys are stable
+    };
+
+    // Return the intern pool, which is never destroyed, so that strings destroyed at exit can still leave it.
+    static InternPool& intern_pool()
+    {
+        static auto* pool = new InternPool;
+        return *pool;
+    }
+
+    // Rarely used state allocated on the first use, null if not needed yet.
+    mutable std::atomic<Extra*> extra_ = nullptr;
+
+    // Position of the first character in the shared buffer.
+    int offset_ = 0;
+
+    // Number of characters.
+    int size_ = 0;
+
+    // Return the shared index of all ASCII strings.
+    static const Utf8Index* ascii_index()
+    {
+        static const Utf8Index index;
+        return &index;
+    }
+
+    // Free an index built for this string.
+    static void release(const Utf8Index* index)
+    {
+        if (index != ascii_index())
+        {
+            delete index;
+        }
+    }
+
+    // Drop a reference to the rarely used state, and free it if it is the last one.
+    static void release(Extra* extra)
+    {
+        if (extra && extra->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete extra;
+        }
+    }
+
+    // Return the rarely used state, allocated on the first call.
+    Extra& extra() const
+    {
+        Extra* extra = extra_.load(std::memory_order_acquire);
+        if (!extra)
+        {
+            auto* created = new Extra;
+            if (extra_.compare_exchange_strong(extra, created, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return *created;
+            }
+            delete created; // allocated by another thread at the same time
+        }
+        return *extra;
+    }
+
+    // Whether the characters are stored inline.
+    bool is_small() const
+    {
+        return size_ <= SMALL_SIZE;
+    }
+
+    // Free the buffer and the rarely used state, leaving an empty string.
+    void reset() noexcept
+    {
+        if (!is_small())
+        {
+            buffer_.~shared_ptr();
+            small_[0] = 0;
+        }
+        release(extra_.exchange(nullptr, std::memory_order_acq_rel));
+        offset_ = 0;
+        size_ = 0;
+    }
+
+    // Take over the characters and state of `that`, leaving it empty, require this string is empty.
+    void steal(Str& that) noexcept
+    {
+        if (that.is_small())
+        {
+            std::copy(std::begin(that.small_), std::end(that.small_), small_);
+        }
+        else
+        {
+            new (&buffer_) std::shared_ptr<const std::string>(std::move(that.buffer_));
+            that.buffer_.~shared_ptr();
+        }
+        that.small_[0] = 0;
+        extra_.store(that.extra_.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+        offset_ = std::exchange(that.offset_, 0);
+        size_ = std::exchange(that.size_, 0);
+    }
+
+    // Share the characters and state of `that`, require this string is empty.
+    void share_with(const Str& that)
+    {
+        if (that.is_small())
+        {
+            std::copy(std::begin(that.small_), std::end(that.small_), small_);
+        }
+        else
+        {
+            new (&buffer_) std::shared_ptr<const std::string>(that.buffer_);
+        }
+        Extra* extra = that.extra_.load(std::memory_order_acquire);
+        if (extra)
+        {
+            extra->refs.fetch_add(1, std::memory_order_relaxed);
+            extra_.store(extra, std::memory_order_release);
+        }
+        offset_ = that.offset_;
+        size_ = that.size_;
+    }
+
+    // Return the index of code points, validate the string and build the index on the first call.
+    // A short ASCII string is checked again on each call rather than allocating the state.
+    const Utf8Index& utf8_index() const
+    {
+        Extra* state = extra_.load(std::memory_order_acquire);
+        const Utf8Index* index = state ? state->utf8.load(std::memory_order_acquire) : nullptr;
+        if (index)
+        {
+            return *index;
+        }
+
+        const char* first = data();
+        const char* last = first + size_;
+        const Utf8Index* built = ascii_index();
+        if (!StrView(*this).is_ascii())
+        {
+            auto* utf8 = new Utf8Index;
+            std::unique_ptr<Utf8Index> guard(utf8);
+            int cnt = 0;
+            for (const char* p = first; p != last;)
+            {
+                if (cnt % Utf8Index::STRIDE == 0)
+                {
+                    utf8->offsets.push_back(p - first);
+                }
+
+                // ASCII run up to the next recorded code point, 32 or 16 bytes at a time with SIMD
+                const char* run_end = p + std::min<std::ptrdiff_t>(last - p, Utf8Index::STRIDE - cnt % Utf8Index::STRIDE);
+                const char* q = StrView::skip<StrView::Ascii::ASCII>(p, run_end);
+                cnt += q - p;
+                p = q;
+                if (p != run_end)
+                {
+                    int len = StrView::utf8_length(p, last);
+                    if (len == 0)
+                    {
+                        throw std::runtime_error("Error: Invalid UTF-8 string.");
+                    }
+                    p += len;
+                    ++cnt;
+                }
+            }
+            utf8->size = cnt;
+            built = guard.release();
+        }
+        else if (is_small())
+        {
+            return *built;
+        }
+
+        if (!extra().utf8.compare_exchange_strong(index, built, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            release(built); // built by another thread at the same time
+            return *index;
+        }
+        return *built;
+    }
+
+    // Return the byte offset of the code point at `index`, or the size for the end, require a valid index.
+    int utf8_offset(const Utf8Index& utf8, int index) const
+    {
+        if (utf8.size == -1 || index == utf8.size)
+        {
+            return utf8.size == -1 ? index : size_;
+        }
+
+        const char* chars = data();
+        int offset = utf8.offsets[index / Utf8Index::STRIDE];
+        for (int i = index % Utf8Index::STRIDE; i > 0; --i)
+        {
+            offset += StrView::utf8_sequence_length(chars[offset]);
+        }
+        return offset;
+    }
+
+    // Create a string from the characters, inline if short, otherwise in a new shared buffer.
+    void assign(std::string_view chars)
+    {
+        if (int(chars.size()) <= SMALL_SIZE)
+        {
+            std::copy(chars.begin(), chars.end(), small_);
+            small_[chars.size()] = 0;
+        }
+        else
+        {
+            new (&buffer_) std::shared_ptr<const std::string>(std::make_shared<const std::string>(chars));
+        }
+        size_ = chars.size();
+    }
+
+    // Return the characters of the string.
+    std::string_view chars() const
+    {
+        return std::string_view(data(), size_);
+    }
+
+    // Return the substring in the range [`start`, `stop`), sharing the buffer if it is not short. O(1)
+    Str share(int start, int stop) const
+    {
+        if (stop - start <= SMALL_SIZE)
+        {
+            return Str(StrView(chars().substr(start, stop - start)));
+        }
+
+        Str substr;
+        new (&substr.buffer_) std::shared_ptr<const std::string>(buffer_);
+        substr.offset_ = offset_ + start;
+        substr.size_ = stop - start;
+        return substr;
+    }
+
+    // Return the substring viewed by `view`, a view into this string.
+    Str share(StrView view) const
+    {
+        int start = view.data() - data();
+        return share(start, start + view.size());
+    }
+
+    // Convert the case of the UTF-8 string, see `utf8_lower` and `utf8_upper`.
+    template <StrView::Case C>
+    Str utf8_convert_case() const
+    {
+        if (utf8_index().size == -1)
+        {
+            return C == StrView::Case::LOWER ? lower() : upper();
+        }
+
+        const char* first = data();
+        const char* last = first + size_;
+        std::string buffer;
+        buffer.reserve(size_);
+        bool cased = false; // whether the last code point is a letter with case, for the final sigma
+        for (const char* p = first; p != last;)
+        {
+            // ASCII run with the SIMD kernel
+            const char* q = StrView::skip<StrView::Ascii::ASCII>(p, last);
+            if (q != p)
+            {
+                std::size_t offset = buffer.size();
+                buffer.resize(offset + (q - p));
+                StrView::convert_case<C>(p, q, buffer.data() + offset);
+                cased = StrView::in_class<StrView::Ascii::ALPHA>(q[-1], 0);
+                p = q;
+                continue;
+            }
+
+            int len = StrView::utf8_sequence_length(*p);
+            char32_t cp = StrView::utf8_decode(p, len);
+            p += len;
+            if constexpr (C == StrView::Case::LOWER)
+            {
+                if (cp == 0x130) // 'İ' to "i̇" (i with combining dot above)
+                {
+                    buffer += "i\xcc\x87";
+                }
+                else if (cp == 0x3A3 && cased && (p == last || !StrView::is_cased(StrView::utf8_decode(p, StrView::utf8_sequence_length(*p)))))
+                {
+                    StrView::utf8_encode(buffer, 0x3C2); // final sigma at the end of a word
+                }
+                else
+                {
+                    StrView::utf8_encode(buffer, StrView::lower_code_point(cp));
+                }
+            }
+            else
+            {
+                if (cp == 0xDF) // 'ß' to "SS"
+                {
+                    buffer += "SS";
+                }
+                else
+                {
+                    StrView::utf8_encode(buffer, StrView::upper_code_point(cp));
+                }
+            }
+            cased = StrView::is_cased(cp);
+        }
+        return buffer;
+    }
+
+    // Return the hash of the string, computed on the first call. A short string without state is hashed on each call.
+    std::size_t hash() const
+    {
+        if (is_small() && !extra_.load(std::memory_order_acquire))
+        {
+            return std::hash<std::string_view>{}(chars());
+        }
+
+        Extra& state = extra();
+        std::size_t hash = state.hash.load(std::memory_order_relaxed);
+        if (hash == 0)
+        {
+            hash = std::hash<std::string_view>{}(chars()); // same as the hash of StrView
+            state.hash.store(hash, std::memory_order_relaxed);
+        }
+        return hash;
+    }
+
+    // Return the cached hash, 0 if not computed yet.
+    std::size_t cached_hash() const
+    {
+        Extra* extra = extra_.load(std::memory_order_acquire);
+        return extra ? extra->hash.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Return the characters in the intern pool, null if the string is not interned.
+    const std::string* interned() const
+    {
+        Extra* extra = extra_.load(std::memory_order_acquire);
+        return extra ? extra->interned : nullptr;
+    }
+
+    // View the characters of a string-like object: Str, StrView, std::string, std::string_view, const char*, etc.
+    template <typename T>
+    static std::string_view view(const T& str)
+    {
+        if constexpr (std::is_same_v<T, Str>)
+        {
+            return str.chars();
+        }
+        else if constexpr (std::is_same_v<T, StrView>)
+        {
+            return str.view();
+        }
+        else
+        {
+            return std::string_view(str);
+        }
+    }
+
+    // Parsed format spec of a replacement field: [[fill]align][sign][#][0][width][.precision][type], like Python.
+    struct FormatSpec
+    {
+        char fill = 0;       // 0 for the default
+        char align = 0;      // '<', '>', '^', '=' or 0 for the default
+        char sign = 0;       // '+', '-', ' ' or 0 for the default
+        bool alt = false;    // '#', prefix "0b", "0o", "0x" for integers
+        bool zero = false;   // '0', pad numbers with zeros after the sign
+        int width = 0;       // minimum width
+        int precision = -1;  // -1 for the default
+        char type = 0;       // presentation type, 0 for the default
+    };
+
+    // Replacement field of a format string.
+    struct FormatField
+    {
+        std::size_t literal_end = 0; // end of the literal text before the field
+        std::size_t next = 0;        // start of the text after the field
+        bool escaped = false;        // whether the literal text contains "{{" or "}}"
+        bool found = false;          // false if the format string has no more fields
+        bool has_spec = false;       // whether the field has ":spec"
+        int index = -1;              // index of the argument, -1 for the next argument in order
+        FormatSpec spec;
+    };
+
+    // Kind of a formatted argument, determines the valid specs.
+    enum class FormatKind
+    {
+        INTEGER,
+        CHAR,
+        FLOAT,
+        STRING,
+        OTHER, // printed with operator<<
+    };
+
+    template <typename T>
+    static constexpr FormatKind format_kind()
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> || std::is_same_v<U, unsigned char>)
+        {
+            return FormatKind::CHAR;
+        }
+        else if constexpr (std::is_integral_v<U> || std::is_same_v<U, Int>)
+        {
+            return FormatKind::INTEGER;
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            return FormatKind::FLOAT;
+        }
+        else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*> || std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+        {
+            return FormatKind::STRING;
+        }
+        else
+        {
+            return FormatKind::OTHER;
+        }
+    }
+
+    // Parse the format spec `str`, return false if it is invalid.
+    static constexpr bool parse_spec(std::string_view str, FormatSpec& spec)
+    {
+        auto is_align = [](char ch)
+        { return ch == '<' || ch == '>' || ch == '^' || ch == '='; };
+        auto is_digit = [](char ch)
+        { return ch >= '0' && ch <= '9'; };
+
+        std::size_t i = 0;
+        if (str.size() >= 2 && is_align(str[1]))
+        {
+            spec.fill = str[0];
+            spec.align = str[1];
+            i = 2;
+        }
+        else if (!str.empty() && is_align(str[0]))
+        {
+            spec.align = str[0];
+            i = 1;
+        }
+        if (i < str.size() && (str[i] == '+' || str[i] == '-' || str[i] == ' '))
+        {
+            spec.sign = str[i++];
+        }
+        if (i < str.size() && str[i] == '#')
+        {
+            spec.alt = true;
+            ++i;
+        }
+        if (i < str.size() && str[i] == '0')
+        {
+            spec.zero = true;
+            ++i;
+        }
+        for (; i < str.size() && is_digit(str[i]); ++i)
+        {
+            if (spec.width > (INT_MAX - 9) / 10)
+            {
+                return false;
+            }
+            spec.width = spec.width * 10 + (str[i] - '0');
+        }
+        if (i < str.size() && str[i] == '.')
+        {
+            if (++i == str.size() || !is_digit(str[i]))
+            {
+                return false;
+            }
+            for (spec.precision = 0; i < str.size() && is_digit(str[i]); ++i)
+            {
+                if (spec.precision > (INT_MAX - 9) / 10)
+                {
+                    return false;
+                }
+                spec.precision = spec.precision * 10 + (str[i] - '0');
+            }
+        }
+        if (i < str.size())
+        {
+            spec.type = str[i++];
+            if (std::string_view("bcdoxXeEfFgGs%").find(spec.type) == std::string_view::npos)
+            {
+                return false;
+            }
+        }
+        return i == str.size();
+    }
+
+    // Return true if the format spec is valid for an argument of type `T`.
+    template <typename T>
+    static constexpr bool accepts(const FormatSpec& spec)
+    {
+        auto type_in = [&](std::string_view types)
+        { return spec.type != 0 && types.find(spec.type) != std::string_view::npos; };
+        const bool numeric_flags = spec.sign || spec.alt || spec.align == '=';
+
+        switch (format_kind<T>())
+        {
+            case FormatKind::INTEGER:
+                if (type_in("eEfFgG%"))
+                {
+                    return std::is_integral_v<std::decay_t<T>>; // Int is not converted to floating-point
+                }
+                return (spec.type == 0 || type_in("bdoxX")) && spec.precision == -1;
+
+            case FormatKind::CHAR:
+                if (type_in("bdoxX"))
+                {
+                    return spec.precision == -1;
+                }
+                return (spec.type == 0 || spec.type == 'c') && !numeric_flags && spec.precision == -1;
+
+            case FormatKind::FLOAT:
+                return spec.type == 0 || type_in("eEfFgG%");
+
+            case FormatKind::STRING:
+                return (spec.type == 0 || spec.type == 's') && !numeric_flags;
+
+            default:
+                return spec.type == 0 && !numeric_flags && spec.precision == -1;
+        }
+    }
+
+    // Find the next replacement field `{[index|name][:spec]}` of `format` from `pos`, return false if the spec is invalid.
+    // A name takes the next argument in order, and an unmatched brace is literal text, like earlier versions.
+    static constexpr bool next_field(std::string_view format, std::size_t pos, FormatField& field)
+    {
+        field = FormatField();
+        for (std::size_t i = pos; i < format.size(); ++i)
+        {
+            if ((format[i] == '{' || format[i] == '}') && i + 1 < format.size() && format[i + 1] == format[i])
+            {
+                field.escaped = true;
+                ++i;
+            }
+            else if (format[i] == '{')
+            {
+                std::size_t close = format.find('}', i + 1);
+                if (close == std::string_view::npos)
+                {
+                    break; // no more fields
+                }
+
+                std::string_view inside = format.substr(i + 1, close - i - 1);
+                std::size_t colon = inside.find(':');
+                std::string_view id = inside.substr(0, colon);
+                if (!id.empty() && id.find_first_not_of("0123456789") == std::string_view::npos)
+                {
+                    field.index = 0;
+                    for (char digit : id)
+                    {
+                        field.index = field.index > (INT_MAX - 9) / 10 ? INT_MAX : field.index * 10 + (digit - '0');
+                    }
+                }
+                if (colon != std::string_view::npos)
+                {
+                    field.has_spec = true;
+                    if (!parse_spec(inside.substr(colon + 1), field.spec))
+                    {
+                        return false;
+                    }
+
+                    // a lone '}' right after a spec is likely a typo like "{:>5}}"
+                    if (close + 1 < format.size() && format[close + 1] == '}' && (close + 2 == format.size() || format[close + 2] != '}'))
+                    {
+                        return false;
+                    }
+                }
+                field.literal_end = i;
+                field.next = close + 1;
+                field.found = true;
+                return true;
+            }
+        }
+        field.literal_end = format.size();
+        return true;
+    }
+
+    // Append the literal text, replacing "{{" and "}}" with "{" and "}" if `escaped`.
+    static void append_literal(std::string& out, std::string_view literal, bool escaped)
+    {
+        if (!escaped)
+        {
+            out += literal;
+            return;
+        }
+        for (std::size_t i = 0; i < literal.size(); ++i)
+        {
+            out += literal[i];
+            if ((literal[i] == '{' || literal[i] == '}') && i + 1 < literal.size() && literal[i + 1] == literal[i])
+            {
+                ++i; // skip the second brace
+            }
+        }
+    }
+
+    // Append `body` with `prefix` (sign and base prefix of a number), padded to the width of the spec.
+    static void append_padded(std::string& out, std::string_view prefix, std::string_view body, const FormatSpec& spec, bool numeric)
+    {
+        const char fill = spec.fill ? spec.fill : spec.zero ? '0' : ' ';
+        const char align = spec.align ? spec.align : spec.zero && numeric ? '=' : numeric ? '>' : '<';
+        const int n = std::max(0, spec.width - int(prefix.size() + body.size()));
+        switch (align)
+        {
+            case '<':
+                out.append(prefix).append(body).append(n, fill);
+                break;
+            case '>':
+                out.append(n, fill).append(prefix).append(body);
+                break;
+            case '^':
+                out.append(n / 2, fill).append(prefix).append(body).append(n - n / 2, fill);
+                break;
+            default: // '='
+                out.append(prefix).append(n, fill).append(body);
+                break;
+        }
+    }
+
+    // Append a number given its sign and digits.
+    static void append_number(std::string& out, bool negative, std::string_view base_prefix, std::string_view digits, const FormatSpec& spec)
+    {
+        char prefix[3] = {};
+        int len = 0;
+        if (negative || (spec.sign && spec.sign != '-'))
+        {
+            prefix[len++] = negative ? '-' : spec.sign;
+        }
+        if (spec.alt)
+        {
+            for (char ch : base_prefix)
+            {
+                prefix[len++] = ch;
+            }
+        }
+        append_padded(out, std::string_view(prefix, len), digits, spec, true);
+    }
+
+    // Presentation base and prefix of an integer format spec.
+    static std::pair<int, std::string_view> integer_base(char type)
+    {
+        switch (type)
+        {
+            case 'b':
+                return {2, "0b"};
+            case 'o':
+                return {8, "0o"};
+            case 'x':
+                return {16, "0x"};
+            case 'X':
+                return {16, "0X"};
+            default:
+                return {10, ""};
+        }
+    }
+
+    template <std::floating_point T>
+    static void format_float(std::string& out, T value, const FormatSpec& spec)
+    {
+        const bool negative = std::signbit(value);
+        value = spec.type == '%' ? std::abs(value) * 100 : std::abs(value);
+
+        std::chars_format fmt = std::chars_format::general;
+        int precision = spec.precision == -1 ? 6 : spec.precision; // "{}" prints like operator<<
+        if (spec.type == 'e' || spec.type == 'E')
+        {
+            fmt = std::chars_format::scientific;
+        }
+        else if (spec.type == 'f' || spec.type == 'F' || spec.type == '%')
+        {
+            fmt = std::chars_format::fixed;
+        }
+
+        // fixed notation of the largest double has 309 digits before the point,
+        // longer results (long double or large precision) are retried on the heap, one byte is reserved for '%'
+        char stack[400];
+        std::string heap;
+        char* first = stack;
+        auto result = std::to_chars(first, stack + sizeof(stack) - 1, value, fmt, precision);
+        if (result.ec == std::errc::value_too_large)
+        {
+            heap.resize(std::numeric_limits<T>::max_exponent10 + precision + 64);
+            first = heap.data();
+            result = std::to_chars(first, first + heap.size() - 1, value, fmt, precision);
+        }
+        assert(result.ec == std::errc());
+        char* ptr = result.ptr;
+        if (spec.type == 'E' || spec.type == 'F' || spec.type == 'G')
+        {
+            std::transform(first, ptr, first, [](char ch)
+                           { return std::toupper(ch); });
+        }
+        if (spec.type == '%')
+        {
+            *ptr++ = '%';
+        }
+        append_number(out, negative, "", std::string_view(first, ptr - first), spec);
+    }
+
+    template <std::integral T>
+    static void format_integer(std::string& out, T value, const FormatSpec& spec)
     {
-        E_BLANK = 0 << CHAR_BIT, // blank character: ' ', '\n', '\t', '\r'
-        E_SIGN = 1 << CHAR_BIT,  // positive or negative sign: '+', '-'
-        E_DIGIT = 2 << CHAR_BIT, // 36-based digit: '[0-9a-zA-Z]'
-        E_POINT = 3 << CHAR_BIT, // decimal point: '.'
-        E_EXP = 4 << CHAR_BIT,   // scientific notation identifier: 'e', 'E'
-        E_OTHER = 5 << CHAR_BIT, // other
-    };
+        if (spec.type && std::string_view("eEfFgG%").find(spec.type) != std::string_view::npos)
+        {
+            return format_float(out, double(value), spec);
+        }
+
+        using U = std::make_unsigned_t<std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>>;
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>)
+        {
+            negative = value < 0;
+        }
+        const U magnitude = negative ? U(0) - U(value) : U(value);
+
+        auto [base, base_prefix] = integer_base(spec.type);
+        char digits[sizeof(U) * 8];
+        auto [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), magnitude, base);
+        if (spec.type == 'X')
+        {
+            std::transform(digits, ptr, digits, [](char ch)
+                           { return std::toupper(ch); });
+        }
+        append_number(out, negative, base_prefix, std::string_view(digits, ptr - digits), spec);
+    }
 
-    // Try to transform a character to an event.
-    static event get_event(const char ch, const int base)
+    // Append `value` formatted according to `spec`, which has been checked by `accepts`.
+    template <typename T>
+    static void format_value(std::string& out, const T& value, const FormatSpec& spec)
     {
-        if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r')
+        using U = std::decay_t<T>;
+        constexpr FormatKind kind = format_kind<T>();
+        if constexpr (std::is_same_v<U, Int>)
+        {
+            auto [base, base_prefix] = integer_base(spec.type);
+            std::string digits = value.to_string(base);
+            if (spec.type == 'X')
+            {
+                std::transform(digits.begin(), digits.end(), digits.begin(), [](char ch)
+                               { return std::toupper(ch); });
+            }
+            std::string_view magnitude(digits);
+            append_number(out, value.is_negative(), base_prefix, magnitude.substr(value.is_negative()), spec);
+        }
+        else if constexpr (kind == FormatKind::INTEGER)
+        {
+            format_integer(out, value, spec);
+        }
+        else if constexpr (kind == FormatKind::CHAR)
         {
-            return E_BLANK;
+            if (spec.type && spec.type != 'c')
+            {
+                format_integer(out, int(value), spec);
+            }
+            else
+            {
+                const char ch = value;
+                append_padded(out, "", std::string_view(&ch, 1), spec, false);
+            }
         }
-        else if (ch == '+' || ch == '-')
+        else if constexpr (kind == FormatKind::FLOAT)
         {
-            return E_SIGN;
+            format_float(out, value, spec);
         }
-        else if (char_to_integer(ch, base) != -1)
+        else if constexpr (kind == FormatKind::STRING)
         {
-            return E_DIGIT;
+            std::string_view str(value);
+            append_padded(out, "", spec.precision == -1 ? str : str.substr(0, spec.precision), spec, false);
         }
-        else if (ch == '.')
+        else if constexpr (std::is_same_v<U, Str> || std::is_same_v<U, StrView>)
         {
-            return E_POINT;
+            std::string_view str = view(value);
+            if (spec.width == 0)
+            {
+                out.append(1, '"').append(str).append(1, '"');
+            }
+            else
+            {
+                append_padded(out, "", '"' + std::string(str) + '"', spec, false);
+            }
         }
-        else if (ch == 'e' || ch == 'E')
+        else
         {
-            return E_EXP;
+            std::ostringstream oss;
+            oss << value;
+            append_padded(out, "", oss.str(), spec, false);
         }
-        return E_OTHER;
     }
 
-    // Try to transform a character to an integer based on 2-36 base.
-    static int char_to_integer(char digit, int base) // 2 <= base <= 36
+    // Append the argument at `index` of `args` formatted according to `spec`.
+    template <typename... Args>
+    static void format_arg(std::string& out, std::size_t index, const FormatSpec& spec, const Args&... args)
     {
-        std::string_view digits = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-        auto pos = digits.find(std::toupper(digit));
-        return (pos != std::string_view::npos && pos < base) ? pos : -1;
+        std::size_t i = 0;
+        [[maybe_unused]] auto format_if = [&](const auto& arg) // unused if there is no argument
+        {
+            if (i++ == index)
+            {
+                if (!accepts<std::decay_t<decltype(arg)>>(spec))
+                {
+                    throw std::runtime_error("Error: Invalid format spec for the argument.");
+                }
+                format_value(out, arg, spec);
+            }
+        };
+        (format_if(args), ...);
     }
 
-    // Format helper, see https://codereview.stackexchange.com/questions/269425/implementing-stdformat
-    template <typename T>
-    static void format_helper(std::ostringstream& oss, std::string_view& str, const T& value)
+    // Parse `format` at runtime and append it with the fields replaced by `args`.
+    // A field without an argument is left unchanged, and extra arguments are ignored.
+    template <typename... Args>
+    static void append_formatted(std::string& out, std::string_view format, const Args&... args)
     {
-        std::size_t open_bracket = str.find('{');
-        std::size_t close_bracket = str.find('}', open_bracket + 1);
-        if (open_bracket == std::string::npos || close_bracket == std::string::npos)
+        std::size_t pos = 0;
+        std::size_t next = 0; // index of the next argument in order
+        FormatField field;
+        while (true)
         {
-            return;
+            if (!next_field(format, pos, field))
+            {
+                throw std::runtime_error("Error: Invalid format string.");
+            }
+            if (!field.found)
+            {
+                break;
+            }
+
+            append_literal(out, format.substr(pos, field.literal_end - pos), field.escaped);
+            std::size_t index = field.index == -1 ? next++ : field.index;
+            if (index < sizeof...(Args))
+            {
+                format_arg(out, index, field.spec, args...);
+            }
+            else
+            {
+                out += format.substr(field.literal_end, field.next - field.literal_end);
+            }
+            pos = field.next;
         }
-        oss << str.substr(0, open_bracket) << value;
-        str = str.substr(close_bracket + 1);
+        append_literal(out, format.substr(pos), field.escaped);
     }
 
 public:
+    /// Pattern precompiled for searching, see `StrView::Pattern`.
+    using Pattern = StrView::Pattern;
+
+    /// Set of patterns compiled for searching in one pass, see `StrView::PatternSet`.
+    using PatternSet = StrView::PatternSet;
+
+    /// Format string checked and parsed at compile time for the arguments of types `Args`, like `std::format_string`.
+    /// The syntax is the same as `Str::format`, but a field without an argument is also a compile error.
+    ///
+    /// ### Example
+    /// ```
+    /// StrBuilder().append_format("{:>8.3f}|{:#06x}", 3.14159, 255).to_str(); // "   3.142|0x00ff"
+    /// StrBuilder().append_format("{:d}", 3.14); // compile error
+    /// ```
+    template <typename... Args>
+    class Format
+    {
+    private:
+        // Characters of the format string.
+        std::string_view str_;
+
+        // Replacement fields, one for each argument, if the fields take the arguments in order.
+        std::array<FormatField, sizeof...(Args)> fields_{};
+
+        // Literal text after the last field.
+        FormatField tail_;
+
+        // Whether the i-th field takes the i-th argument, otherwise the string is parsed again when formatting.
+        bool sequential_ = true;
+
+        friend class Str;
+        friend class StrBuilder;
+
+        // Return true if the spec is valid for the argument at `index`.
+        static consteval bool accepts_arg(std::size_t index, const FormatSpec& spec)
+        {
+            std::size_t i = 0;
+            bool ok = false;
+            ((ok = i++ == index ? accepts<Args>(spec) : ok), ...);
+            return ok;
+        }
+
+    public:
+        /// Parse the format string at compile time, a mismatch with the arguments is a compile error.
+        template <typename S>
+            requires std::convertible_to<const S&, std::string_view>
+        consteval Format(const S& format)
+            : str_(format)
+        {
+            std::size_t pos = 0;
+            std::size_t count = 0; // number of fields
+            std::size_t next = 0;  // index of the next argument in order
+            while (true)
+            {
+                if (!next_field(str_, pos, tail_))
+                {
+                    throw std::runtime_error("Error: Invalid format string.");
+                }
+                if (!tail_.found)
+                {
+                    break;
+                }
+
+                std::size_t index = tail_.index == -1 ? next++ : tail_.index;
+                if (index >= sizeof...(Args))
+                {
+                    throw std::runtime_error("Error: Not enough arguments for format string.");
+                }
+                if (!accepts_arg(index, tail_.spec))
+                {
+                    throw std::runtime_error("Error: Invalid format spec for the argument.");
+                }
+                if (index != count)
+                {
+                    sequential_ = false;
+                }
+                else
+                {
+                    fields_[count] = tail_;
+                }
+                ++count;
+                pos = tail_.next;
+            }
+        }
+    };
+
     /*
      * Constructor
      */
 
     /// Create an empty string.
-    Str() = default;
+    Str() noexcept
+    {
+    }
 
     /// Create a string from null-terminated characters.
     Str(const char* chars)
-        : str_(chars)
     {
+        assign(chars);
     }
 
     /// Create a string from std::string.
     Str(const std::string& string)
-        : str_(string)
     {
+        assign(string);
+    }
+
+    /// Create a string from std::string, taking over its buffer.
+    Str(std::string&& string)
+    {
+        if (int(string.size()) <= SMALL_SIZE)
+        {
+            assign(string);
+        }
+        else
+        {
+            int size = string.size();
+            new (&buffer_) std::shared_ptr<const std::string>(std::make_shared<const std::string>(std::move(string)));
+            size_ = size;
+        }
+    }
+
+    /// Create a string from a view, copying the viewed characters.
+    explicit Str(StrView view)
+    {
+        assign(view.view());
     }
 
-    /// Copy constructor.
-    Str(const Str& that) = default;
+    /// Copy constructor, O(1): a long string shares the buffer with `that`.
+    Str(const Str& that)
+    {
+        share_with(that);
+    }
 
     /// Move constructor.
     Str(Str&& that) noexcept
-        : str_(std::move(that.str_))
     {
+        steal(that);
+    }
+
+    /// Destructor.
+    ~Str()
+    {
+        reset();
     }
 
     /*
      * Comparison
      */
 
+    /// Determine whether this string is equal to another string.
+    /// Interned strings are compared by identity, and strings with different cached hashes are unequal at once.
+    bool operator==(const Str& that) const
+    {
+        const std::string* pooled = interned();
+        const std::string* that_pooled = that.interned();
+        if (pooled && that_pooled)
+        {
+            return pooled == that_pooled;
+        }
+
+        std::size_t hash = cached_hash();
+        std::size_t that_hash = that.cached_hash();
+        if (hash != 0 && that_hash != 0 && hash != that_hash)
+        {
+            return false;
+        }
+
+        return (data() == that.data() && size_ == that.size_) || chars() == that.chars();
+    }
+
     /// Compare the string with another string.
-    auto operator<=>(const Str& that) const = default;
+    std::strong_ordering operator<=>(const Str& that) const
+    {
+        const std::string* pooled = interned();
+        if (pooled && pooled == that.interned())
+        {
+            return std::strong_ordering::equal;
+        }
+
+        return chars() <=> that.chars();
+    }
 
     /*
      * Assignment
@@ -138,14 +2730,22 @@ public:
     /// Copy assignment operator.
     Str& operator=(const Str& that)
     {
-        str_ = that.str_;
+        if (this != &that)
+        {
+            reset();
+            share_with(that);
+        }
         return *this;
     }
 
     /// Move assignment operator.
     Str& operator=(Str&& that) noexcept
     {
-        str_ = std::move(that.str_);
+        if (this != &that)
+        {
+            reset();
+            steal(that);
+        }
         return *this;
     }
 
@@ -156,25 +2756,25 @@ public:
     /// Return an iterator to the first char of the string.
     auto begin() const
     {
-        return str_.cbegin();
+        return data();
     }
 
     /// Return an iterator to the char following the last char of the string.
     auto end() const
     {
-        return str_.cend();
+        return data() + size_;
     }
 
     /// Return a reverse iterator to the first char of the reversed string.
     auto rbegin() const
     {
-        return str_.crbegin();
+        return std::reverse_iterator(end());
     }
 
     /// Return a reverse iterator to the char following the last char of the reversed string.
     auto rend() const
     {
-        return str_.crend();
+        return std::reverse_iterator(begin());
     }
 
     /*
@@ -187,7 +2787,25 @@ public:
     {
         detail::check_bounds(index, -size(), size());
 
-        return str_[index >= 0 ? index : index + size()];
+        return data()[index >= 0 ? index : index + size()];
+    }
+
+    /// Return the code point at the specified position in the UTF-8 string as a string, like `str[index]` in Python.
+    /// Index can be negative. O(1) amortized with the index of code points, see `utf8_size`.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("héllo, 世界").utf8_at(1); // "é"
+    /// Str("héllo, 世界").utf8_at(-1); // "界"
+    /// ```
+    Str utf8_at(int index) const
+    {
+        const Utf8Index& utf8 = utf8_index();
+        int size = utf8_size();
+        detail::check_bounds(index, -size, size);
+
+        int offset = utf8_offset(utf8, index >= 0 ? index : index + size);
+        return share(offset, offset + StrView::utf8_sequence_length(data()[offset]));
     }
 
     /*
@@ -197,59 +2815,117 @@ public:
     /// Return the number of elements in the string.
     int size() const
     {
-        return str_.size(); // no '\0'
+        return size_;
     }
 
     /// Return true if the string contains no elements.
     bool is_empty() const
     {
-        return str_.empty();
+        return size_ == 0;
     }
 
-    /// Return const pointer to contents. This is a pointer to internal data.
+    /// Return const pointer to contents. This is a pointer to internal data, which may be shared with other strings,
+    /// and is NOT null-terminated for a slice, strip or split piece of a longer string, use `c_str` for C APIs.
     /// It is undefined to modify the contents through the returned pointer.
     const char* data() const
     {
-        return str_.data();
+        return is_small() ? small_ : buffer_->data() + offset_;
     }
 
-    /// Return the index of the first occurrence of the specified pattern in the specified range [`start`, `stop`).
-    /// Or -1 if the string does not contain the pattern (in the specified range).
-    int find(const Str& pattern, int start = 0, int stop = INT_MAX) const
+    /// Return const pointer to the characters followed by a null character, like `std::string::c_str()`.
+    /// It is the same as `data()` unless the string shares the middle of a longer buffer, then the characters are copied
+    /// once on the first call, and the copy is kept until the string is destroyed or assigned.
+    ///
+    /// ### Example
+    /// ```
+    /// Str path = Str("dir/file.txt, other").split(",")[0];
+    /// std::fopen(path.c_str(), "r"); // path.data() is followed by ", other"
+    /// ```
+    const char* c_str() const
     {
-        if (start > size())
+        if (is_small() || offset_ + size_ == int(buffer_->size()))
         {
-            return -1;
+            return data(); // inline, or a suffix of the buffer which is null-terminated
         }
 
-        stop = stop > size() ? size() : stop;
-        std::string_view view(str_.data() + start, stop - start);
-        auto pos = view.find(pattern.str_);
+        Extra& state = extra();
+        const std::string* copy = state.terminated.load(std::memory_order_acquire);
+        if (!copy)
+        {
+            auto* built = new std::string(chars());
+            if (state.terminated.compare_exchange_strong(copy, built, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                copy = built;
+            }
+            else
+            {
+                delete built; // built by another thread at the same time
+            }
+        }
+        return copy->c_str();
+    }
+
+    /// Return `true` if the string is interned, see `intern`.
+    bool is_interned() const
+    {
+        return interned() != nullptr;
+    }
 
-        return pos == std::string::npos ? -1 : start + int(pos);
+    /// Return a view of the string. The view is invalid after the string is destroyed or assigned.
+    operator StrView() const
+    {
+        return StrView(chars());
+    }
+
+    /// Return the index of the first occurrence of the specified pattern in the specified range [`start`, `stop`).
+    /// Or -1 if the string does not contain the pattern (in the specified range).
+    int find(const Str& pattern, int start = 0, int stop = INT_MAX) const
+    {
+        return StrView(*this).find(pattern, start, stop);
     }
 
     /// Return `true` if the string contains the specified `pattern` in the specified range [`start`, `stop`).
     bool contains(const Str& pattern, int start = 0, int stop = INT_MAX) const
     {
-        return find(pattern, start, stop) != -1;
+        return StrView(*this).contains(pattern, start, stop);
     }
 
     /// Count the total number of occurrences of the specified `pattern` in the string.
     int count(const Str& pattern) const
     {
-        if (pattern.is_empty())
-        {
-            return size() + 1;
-        }
+        return StrView(*this).count(pattern);
+    }
 
-        int cnt = 0;
-        for (int start = 0; (start = find(pattern, start)) != -1; start += pattern.size())
-        {
-            ++cnt;
-        }
+    /// Return the index of the first occurrence of the precompiled pattern in the specified range [`start`, `stop`).
+    /// Or -1 if the string does not contain the pattern (in the specified range).
+    int find(const Pattern& pattern, int start = 0, int stop = INT_MAX) const
+    {
+        return StrView(*this).find(pattern, start, stop);
+    }
 
-        return cnt;
+    /// Return `true` if the string contains the precompiled `pattern` in the specified range [`start`, `stop`).
+    bool contains(const Pattern& pattern, int start = 0, int stop = INT_MAX) const
+    {
+        return StrView(*this).contains(pattern, start, stop);
+    }
+
+    /// Count the total number of occurrences of the precompiled `pattern` in the string.
+    int count(const Pattern& pattern) const
+    {
+        return StrView(*this).count(pattern);
+    }
+
+    /// Return the leftmost occurrence of any of the `patterns` starting from `start` as {index, pattern index},
+    /// preferring the longest pattern if several start at the same index. Or {-1, -1} if none occurs.
+    std::pair<int, int> find_any(const PatternSet& patterns, int start = 0) const
+    {
+        return StrView(*this).find_any(patterns, start);
+    }
+
+    /// Count the non-overlapping occurrences of each of the `patterns` in the string in one pass.
+    List<int> count_many(const PatternSet& patterns) const
+    {
+        return StrView(*this).count_many(patterns);
     }
 
     /// Convert the string to a double-precision floating-point decimal number.
@@ -268,126 +2944,13 @@ public:
     /// ```
     double to_decimal() const
     {
-        // check infinity or nan
-        static const std::vector pos_infs = {"inf", "+inf", "infinity", "+infinity"};
-        static const std::vector neg_infs = {"-inf", "-infinity"};
-        static const std::vector nans = {"nan", "+nan", "-nan"};
-
-        auto tmp = lower().str_;
-        if (std::find(pos_infs.begin(), pos_infs.end(), tmp) != pos_infs.end())
-        {
-            return INFINITY;
-        }
-        if (std::find(neg_infs.begin(), neg_infs.end(), tmp) != neg_infs.end())
-        {
-            return -INFINITY;
-        }
-        if (std::find(nans.begin(), nans.end(), tmp) != nans.end())
-        {
-            return NAN;
-        }
-
-        // not infinity or nan
-
-        double sign = 1; // default '+'
-        double decimal_part = 0;
-        int decimal_cnt = 0;
-        double exp_sign = 1; // default '+'
-        int exp_part = 0;
-
-        // Finite State Machine
-        // State Transition Diagram for Graphviz:
-        /*
-        digraph fsm {
-            rankdir=LR;
-            node [shape = doublecircle]; int dec e_num end;
-            node [shape = circle];
-            start -> start [label = "blank"];
-            start -> sign [label = "sign"];
-            {start sign} -> point [label = "point"];
-            {start sign int} -> int [label = "digit"];
-            int -> dec [label = "point"];
-            {point dec} -> dec [label = "digit"];
-            {int dec} -> exp [label = "exp"];
-            exp -> e_sign [label = "sign"];
-            {exp e_sign e_num} -> e_num [label = "digit"];
-            {int dec e_num end} -> end [label = "blank"];
-        }
-        */
-        state st = S_START;
-        for (int i = 0; i < size(); ++i)
-        {
-            event ev = get_event(str_[i], 10);
-            switch (int(st) | int(ev))
-            {
-                case int(S_START) | int(E_BLANK):
-                    st = S_START;
-                    break;
-
-                case int(S_START) | int(E_SIGN):
-                    sign = (str_[i] == '+') ? 1 : -1;
-                    st = S_SIGN;
-                    break;
-
-                case int(S_START) | int(E_POINT):
-                case int(S_SIGN) | int(E_POINT):
-                    st = S_POINT;
-                    break;
-
-                case int(S_START) | int(E_DIGIT):
-                case int(S_SIGN) | int(E_DIGIT):
-                case int(S_INT) | int(E_DIGIT):
-                    decimal_part = decimal_part * 10 + char_to_integer(str_[i], 10);
-                    st = S_INT;
-                    break;
-
-                case int(S_INT) | int(E_POINT):
-                    st = S_DEC;
-                    break;
-
-                case int(S_POINT) | int(E_DIGIT):
-                case int(S_DEC) | int(E_DIGIT):
-                    decimal_part = decimal_part * 10 + char_to_integer(str_[i], 10);
-                    decimal_cnt++;
-                    st = S_DEC;
-                    break;
-
-                case int(S_INT) | int(E_EXP):
-                case int(S_DEC) | int(E_EXP):
-                    st = S_EXP;
-                    break;
-
-                case int(S_EXP) | int(E_SIGN):
-                    exp_sign = (str_[i] == '+') ? 1 : -1;
-                    st = S_EXP_SIGN;
-                    break;
-
-                case int(S_EXP) | int(E_DIGIT):
-                case int(S_EXP_SIGN) | int(E_DIGIT):
-                case int(S_EXP_NUM) | int(E_DIGIT):
-                    exp_part = exp_part * 10 + char_to_integer(str_[i], 10);
-                    st = S_EXP_NUM;
-                    break;
-
-                case int(S_INT) | int(E_BLANK):
-                case int(S_DEC) | int(E_BLANK):
-                case int(S_EXP_NUM) | int(E_BLANK):
-                case int(S_END) | int(E_BLANK):
-                    st = S_END;
-                    break;
-
-                default:
-                    st = S_OTHER;
-                    i = size(); // exit loop
-                    break;
-            }
-        }
-        if (st != S_INT && st != S_DEC && st != S_EXP_NUM && st != S_END)
-        {
-            throw std::runtime_error("Error: Invalid literal for to_decimal().");
-        }
+        return StrView(*this).to_decimal();
+    }
 
-        return sign * ((decimal_part / std::pow(10, decimal_cnt)) * std::pow(10, exp_sign * exp_part));
+    /// Convert a column of decimal numbers in the string to a list in one pass, see `StrView::to_decimals`.
+    List<double> to_decimals(std::optional<char> sep = std::nullopt) const
+    {
+        return StrView(*this).to_decimals(sep);
     }
 
     /// Convert the string to an `Int` based on 2-36 `base`.
@@ -403,73 +2966,108 @@ public:
     /// ```
     Int to_integer(int base = 10) const
     {
-        // check base
-        if (base < 2 || base > 36)
-        {
-            throw std::runtime_error("Error: Invalid base for to_integer().");
-        }
+        return StrView(*this).to_integer(base);
+    }
 
-        bool non_negative = true; // default '+'
-        Int integer;
+    /// Return `true` if the string is not empty and all the characters are ASCII digits, see `StrView::is_digit`.
+    bool is_digit() const
+    {
+        return StrView(*this).is_digit();
+    }
 
-        // FSM
-        state st = S_START;
-        for (int i = 0; i < size(); ++i)
-        {
-            event ev = get_event(str_[i], base);
-            switch (int(st) | int(ev))
-            {
-                case int(S_START) | int(E_BLANK):
-                    st = S_START;
-                    break;
+    /// Return `true` if the string is not empty and all the characters are ASCII letters, see `StrView::is_alpha`.
+    bool is_alpha() const
+    {
+        return StrView(*this).is_alpha();
+    }
 
-                case int(S_START) | int(E_SIGN):
-                    non_negative = (str_[i] == '+') ? true : false;
-                    st = S_SIGN;
-                    break;
+    /// Return `true` if the string is not empty and all the characters are ASCII letters or digits, see `StrView::is_alnum`.
+    bool is_alnum() const
+    {
+        return StrView(*this).is_alnum();
+    }
 
-                case int(S_START) | int(E_DIGIT):
-                case int(S_SIGN) | int(E_DIGIT):
-                case int(S_INT) | int(E_DIGIT):
-                    integer = integer * base + char_to_integer(str_[i], base);
-                    st = S_INT;
-                    break;
+    /// Return `true` if the string is not empty and all the characters are ASCII whitespace, see `StrView::is_space`.
+    bool is_space() const
+    {
+        return StrView(*this).is_space();
+    }
 
-                case int(S_INT) | int(E_BLANK):
-                case int(S_END) | int(E_BLANK):
-                    st = S_END;
-                    break;
+    /// Return `true` if the string is empty or all the characters are ASCII, see `StrView::is_ascii`.
+    bool is_ascii() const
+    {
+        return StrView(*this).is_ascii();
+    }
 
-                default:
-                    st = S_OTHER;
-                    i = size(); // exit loop
-                    break;
-            }
-        }
-        if (st != S_INT && st != S_END)
-        {
-            throw std::runtime_error("Error: Invalid literal for to_integer().");
-        }
+    /// Return `true` if the string is valid UTF-8, see `StrView::is_utf8`.
+    bool is_utf8() const
+    {
+        return StrView(*this).is_utf8();
+    }
 
-        return non_negative ? integer : -integer;
+    /// Return the number of code points of the UTF-8 string, like `len()` of `str` in Python.
+    /// The string is validated and indexed on the first call, so the access by code point is O(1) afterwards.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("héllo, 世界").utf8_size(); // 9
+    /// Str("\xff").utf8_size(); // throw std::runtime_error
+    /// ```
+    int utf8_size() const
+    {
+        int size = utf8_index().size;
+        return size == -1 ? size_ : size;
     }
 
     /// Return `true` if the string begins with the specified string, otherwise return `false`.
     bool starts_with(const Str& str) const
     {
-        return str_.starts_with(str.str_);
+        return chars().starts_with(str.chars());
     }
 
     /// Return `true` if the string ends with the specified string, otherwise return `false`.
     bool ends_with(const Str& str) const
     {
-        return str_.ends_with(str.str_);
+        return chars().ends_with(str.chars());
     }
 
     /*
      * Production
      */
 
+    /// Return an interned copy of the string, like `sys.intern()` in Python.
+    ///
+    /// Equal strings are interned to the same entry of a global pool, so interned strings are compared by identity in O(1),
+    /// and their hash is computed only once. The pool is thread-safe, and an entry is removed when the last string interned to it
+    /// is destroyed, so interning untrusted input does not grow the pool beyond the strings still alive.
+    ///
+    /// ### Example
+    /// ```
+    /// Str a = Str("key").intern(), b = Str("k") + "ey";
+    /// a == b.intern(); // true, without comparing the characters
+    /// ```
+    Str intern() const
+    {
+        if (interned())
+        {
+            return *this;
+        }
+
+        auto state = std::make_unique<Extra>(); // not shared with this string, which stays not interned
+        state->hash.store(hash(), std::memory_order_relaxed);
+        {
+            InternPool& pool = intern_pool();
+            std::lock_guard lock(pool.mutex);
+            auto it = pool.entries.try_emplace(std::string(chars()), 0).first;
+            ++it->second;
+            state->interned = &it->first;
+        }
+
+        Str result(*this);
+        release(result.extra_.exchange(state.release(), std::memory_order_acq_rel));
+        return result;
+    }
+
     /// Copy and rotate the string to right `n` characters.
     Str operator>>(int n) const
     {
@@ -516,21 +3114,27 @@ public:
         return buffer;
     }
 
-    /// Return a copy of the string with all the characters converted to lowercase.
+    /// Return a copy of the string with all the ASCII letters converted to lowercase.
     Str lower() const
     {
-        std::string buffer(str_);
-        std::transform(buffer.begin(), buffer.end(), buffer.begin(), [](char c)
-                       { return std::tolower(c); });
+        std::string buffer(size_, 0);
+        StrView::convert_case<StrView::Case::LOWER>(begin(), end(), buffer.data());
         return buffer;
     }
 
-    /// Return a copy of the string with all the characters converted to uppercase.
+    /// Return a copy of the string with all the ASCII letters converted to uppercase.
     Str upper() const
     {
-        std::string buffer(str_);
-        std::transform(buffer.begin(), buffer.end(), buffer.begin(), [](char c)
-                       { return std::toupper(c); });
+        std::string buffer(size_, 0);
+        StrView::convert_case<StrView::Case::UPPER>(begin(), end(), buffer.data());
+        return buffer;
+    }
+
+    /// Return a copy of the string with the ASCII uppercase letters converted to lowercase and vice versa.
+    Str swapcase() const
+    {
+        std::string buffer(size_, 0);
+        StrView::convert_case<StrView::Case::SWAP>(begin(), end(), buffer.data());
         return buffer;
     }
 
@@ -540,7 +3144,7 @@ public:
         detail::check_bounds(start, 0, size() + 1);
         detail::check_bounds(stop, 0, size() + 1);
 
-        std::string buffer = str_;
+        std::string buffer(chars());
         buffer.erase(buffer.begin() + start, buffer.begin() + stop);
 
         return buffer;
@@ -557,45 +3161,107 @@ public:
     {
         if (old_str.is_empty())
         {
-            std::ostringstream ss;
-            std::copy(str_.begin(), str_.end(), std::ostream_iterator<char>(ss, new_str.data()));
-            return new_str.str_ + ss.str();
+            std::string buffer;
+            buffer.reserve(size() + (size() + 1) * new_str.size());
+            buffer += new_str.chars();
+            for (const auto& ch : chars())
+            {
+                buffer += ch;
+                buffer += new_str.chars();
+            }
+            return buffer;
+        }
+
+        // find all occurrences first, so that the result is filled into one preallocated buffer
+        std::vector<int> matches;
+        for (int patt_start = 0; (patt_start = find(old_str, patt_start)) != -1; patt_start += old_str.size())
+        {
+            matches.push_back(patt_start);
         }
 
         std::string buffer;
+        buffer.reserve(size() + int(matches.size()) * (new_str.size() - old_str.size()));
         int this_start = 0;
-        for (int patt_start; (patt_start = find(old_str, this_start)) != -1; this_start = patt_start + old_str.size())
+        for (const auto& patt_start : matches)
         {
-            buffer += str_.substr(this_start, patt_start - this_start) + new_str.str_;
+            buffer.append(chars(), this_start, patt_start - this_start);
+            buffer += new_str.chars();
+            this_start = patt_start + old_str.size();
         }
+        buffer.append(chars(), this_start);
 
-        return buffer += str_.substr(this_start);
+        return buffer;
     }
 
-    /// Remove leading and trailing characters (default is blank character) of the string.
-    Str strip(std::optional<char> ch = std::nullopt) const
+    /// Replace the occurrences of all the `patterns` with the corresponding `replacements` in one pass.
+    /// The leftmost occurrence wins, then the longest pattern, and the replaced text is not searched again.
+    ///
+    /// ### Example
+    /// ```
+    /// Str::PatternSet keywords({"cat", "category", "dog"});
+    /// Str("dog category").replace_many(keywords, {"animal", "class", "pet"}); // "pet class"
+    /// ```
+    Str replace_many(const PatternSet& patterns, const List<Str>& replacements) const
     {
-        std::string buffer = str_;
-
-        int i = 0;
-        while (i < int(buffer.size()) && (!ch.has_value() ? buffer[i] <= 0x20 : buffer[i] == *ch))
+        if (patterns.size() != replacements.size())
         {
-            ++i;
+            throw std::runtime_error("Error: Require the same number of patterns and replacements for replace_many.");
         }
-        buffer.erase(buffer.begin(), buffer.begin() + i);
 
-        i = buffer.size() - 1;
-        while (i >= 0 && (!ch.has_value() ? buffer[i] <= 0x20 : buffer[i] == *ch))
+        std::string buffer;
+        buffer.reserve(size());
+        int this_start = 0;
+        for (auto match = patterns.search(chars(), 0); match.second != -1; match = patterns.search(chars(), this_start))
         {
-            --i;
+            auto [patt_start, p] = match;
+            buffer.append(chars(), this_start, patt_start - this_start);
+            buffer += replacements[p].chars();
+            this_start = patt_start + patterns.patterns_[p].size();
         }
-        buffer.erase(buffer.begin() + i + 1, buffer.end());
+        buffer.append(chars(), this_start);
 
         return buffer;
     }
 
+    /// Replace the occurrences of all the keys of `replacements` with the corresponding values in one pass.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("hello world").replace_many({{"hello", "bye"}, {"world", "moon"}}); // "bye moon"
+    /// ```
+    Str replace_many(const Dict<Str, Str>& replacements) const
+    {
+        List<Str> keys, values;
+        for (const auto& [key, value] : replacements)
+        {
+            keys += key;
+            values += value;
+        }
+        return replace_many(PatternSet(keys), values);
+    }
+
+    /// Remove leading and trailing characters (default is blank character) of the string.
+    /// The result shares the characters with the string instead of copying them.
+    Str strip(std::optional<char> ch = std::nullopt) const
+    {
+        return share(StrView(*this).strip(ch));
+    }
+
+    /// Remove leading characters (default is blank character) of the string, sharing the characters.
+    Str lstrip(std::optional<char> ch = std::nullopt) const
+    {
+        return share(StrView(*this).lstrip(ch));
+    }
+
+    /// Remove trailing characters (default is blank character) of the string, sharing the characters.
+    Str rstrip(std::optional<char> ch = std::nullopt) const
+    {
+        return share(StrView(*this).rstrip(ch));
+    }
+
     /// Return slice of the string from `start` to `stop` with certain `step`.
     /// Index and step length can be negative.
+    /// With `step` 1 the slice shares the characters with the string in O(1).
     Str slice(int start, int stop, int step = 1) const
     {
         if (step == 0)
@@ -610,26 +3276,145 @@ public:
         start = start < 0 ? start + size() : start;
         stop = stop < 0 ? stop + size() : stop;
 
+        if (step == 1)
+        {
+            return start < stop ? share(start, stop) : Str();
+        }
+
         // copy
         std::string buffer;
         for (int i = start; (step > 0) ? (i < stop) : (i > stop); i += step)
         {
-            buffer += str_[i];
+            buffer += data()[i];
+        }
+
+        return buffer;
+    }
+
+    /// Return slice of the UTF-8 string from `start` to `stop` with certain `step` in code points, like `str[start:stop:step]` in Python.
+    /// Index and step length can be negative. With `step` 1 the slice shares the characters with the string in O(1) amortized.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("héllo, 世界").utf8_slice(1, 4); // "éll"
+    /// Str("héllo, 世界").utf8_slice(-1, -4, -1); // "界世 "
+    /// ```
+    Str utf8_slice(int start, int stop, int step = 1) const
+    {
+        if (step == 0)
+        {
+            throw std::runtime_error("Error: Require step != 0 for slice(start, stop, step).");
+        }
+
+        const Utf8Index& utf8 = utf8_index();
+        int size = utf8_size();
+        detail::check_bounds(start, -size, size);
+        detail::check_bounds(stop, -size - 1, size + 1);
+
+        start = start < 0 ? start + size : start;
+        stop = stop < 0 ? stop + size : stop;
+
+        if (step == 1)
+        {
+            return start < stop ? share(utf8_offset(utf8, start), utf8_offset(utf8, stop)) : Str();
+        }
+
+        std::string buffer;
+        const char* chars = data();
+        for (int i = start; (step > 0) ? (i < stop) : (i > stop); i += step)
+        {
+            int offset = utf8_offset(utf8, i);
+            buffer.append(chars + offset, StrView::utf8_sequence_length(chars[offset]));
+        }
+        return buffer;
+    }
+
+    /// Return the UTF-8 string with the code points in reverse order, like `str[::-1]` in Python.
+    Str utf8_reverse() const
+    {
+        if (utf8_index().size == -1)
+        {
+            return reverse();
         }
 
+        std::string buffer(size_, 0);
+        const char* chars = data();
+        for (int i = 0; i < size_;)
+        {
+            int len = StrView::utf8_sequence_length(chars[i]);
+            std::copy(chars + i, chars + i + len, buffer.end() - i - len);
+            i += len;
+        }
         return buffer;
     }
 
+    /// Return a copy of the UTF-8 string with the letters converted to lowercase, like `str.lower()` in Python,
+    /// for ASCII, Latin-1, Latin Extended-A, Greek (with the final sigma) and Cyrillic. Other code points are kept.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("ÀÉÎ ΟΔΟΣ ПРИВЕТ").utf8_lower(); // "àéî οδος привет"
+    /// ```
+    Str utf8_lower() const
+    {
+        return utf8_convert_case<StrView::Case::LOWER>();
+    }
+
+    /// Return a copy of the UTF-8 string with the letters converted to uppercase, like `str.upper()` in Python,
+    /// for ASCII, Latin-1, Latin Extended-A, Greek and Cyrillic. Other code points are kept.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("straße, привет").utf8_upper(); // "STRASSE, ПРИВЕТ"
+    /// ```
+    Str utf8_upper() const
+    {
+        return utf8_convert_case<StrView::Case::UPPER>();
+    }
+
+    /// Return a copy of the string that owns only its own characters.
+    /// A slice, strip or split piece of a large string keeps the whole parent alive, `compact` drops the reference to it.
+    ///
+    /// ### Example
+    /// ```
+    /// Str line = Str(huge_text).slice(0, 80); // shares huge_text
+    /// line = line.compact(); // huge_text can be freed
+    /// ```
+    Str compact() const
+    {
+        if (is_small() || int(buffer_->size()) == size_)
+        {
+            return *this;
+        }
+
+        Str compacted{std::string(chars())};
+        Extra* extra = extra_.load(std::memory_order_acquire);
+        if (extra) // same characters, so the state is shared
+        {
+            extra->refs.fetch_add(1, std::memory_order_relaxed);
+            compacted.extra_.store(extra, std::memory_order_release);
+        }
+        return compacted;
+    }
+
     /// Generate a new string and append the specified `element` to the end of the string.
     Str operator+(const char& element) const
     {
-        return str_ + element;
+        std::string buffer;
+        buffer.reserve(size_ + 1);
+        buffer += chars();
+        buffer += element;
+        return buffer;
     }
 
     /// Generate a new string and append the specified `string` to the end of the string.
     Str operator+(const Str& string) const
     {
-        return str_ + string.str_;
+        std::string buffer;
+        buffer.reserve(size_ + string.size_);
+        buffer += chars();
+        buffer += string.chars();
+        return buffer;
     }
 
     /// Generate a new string and add the string to itself a certain number of `times`.
@@ -651,6 +3436,7 @@ public:
 
     /// Split the string with separator (default = " ").
     /// If `keep_empty` is set (default = false), empty strings will be retained.
+    /// The pieces share the characters with the string instead of copying them.
     ///
     /// ### Example
     /// ```
@@ -672,17 +3458,35 @@ public:
         {
             if (keep_empty || patt_start != this_start)
             {
-                str_list += str_.substr(this_start, patt_start - this_start);
+                str_list += share(this_start, patt_start);
             }
         }
         if (keep_empty || this_start != size())
         {
-            str_list += str_.substr(this_start);
+            str_list += share(this_start, size_);
         }
 
         return str_list;
     }
 
+    /// Split the string with separator (default = " ") lazily, returning a forward range of views into this string.
+    /// If `keep_empty` is set (default = false), empty pieces will be retained.
+    ///
+    /// ### Example
+    /// ```
+    /// for (StrView token : Str("one, two, three").split_view(", ")) {} // "one", "two", "three"
+    /// ```
+    StrView::SplitRange split_view(StrView sep = " ", bool keep_empty = false) const
+    {
+        return StrView(*this).split_view(sep, keep_empty);
+    }
+
+    /// Split the string into lines lazily at "\n", "\r\n" or "\r", returning a forward range of views into this string.
+    StrView::SplitRange splitlines_view() const
+    {
+        return StrView(*this).splitlines_view();
+    }
+
     /// Return a string which is the concatenation of the strings in `str_list`.
     ///
     /// ### Example
@@ -691,28 +3495,68 @@ public:
     /// ```
     Str join(const List<Str>& str_list) const
     {
-        if (str_list.is_empty())
+        return join<List<Str>>(str_list);
+    }
+
+    /// Return a string which is the concatenation of the strings in `strs`, a range of `Str`, `std::string_view`, etc.
+    /// The total length is computed first, so the result is filled into one preallocated buffer.
+    ///
+    /// ### Example
+    /// ```
+    /// Str(", ").join(std::vector<std::string_view>{"a", "b"}) // "a, b"
+    /// ```
+    template <std::ranges::forward_range R>
+    Str join(const R& strs) const
+    {
+        std::size_t total = 0, count = 0;
+        for (const auto& str : strs)
+        {
+            total += view(str).size();
+            ++count;
+        }
+        if (count == 0)
         {
             return Str();
         }
 
-        std::string buffer = str_list[0].str_;
-        for (int i = 1; i < str_list.size(); ++i)
+        std::string buffer;
+        buffer.reserve(total + (count - 1) * size_);
+        bool first = true;
+        for (const auto& str : strs)
         {
-            buffer += str_ + str_list[i].str_;
+            if (!first)
+            {
+                buffer += chars();
+            }
+            buffer += view(str);
+            first = false;
         }
         return buffer;
     }
 
     /// Format `args` according to the format string, and return the result as a string.
+    ///
+    /// The replacement fields are `{}`, `{index}` or `{name}`, optionally followed by Python's format spec
+    /// `:[[fill]align][sign][#][0][width][.precision][type]`, and "{{" and "}}" are literal braces.
+    /// A name takes the next argument in order. The format string is parsed at runtime,
+    /// use `StrBuilder::append_format` to parse a constant format string at compile time.
+    /// Extra arguments are ignored, and a field without an argument or an unmatched brace is left unchanged.
+    /// An invalid spec, a spec that does not fit the argument, or a lone "}" right after a spec
+    /// will throw a `runtime_error` exception.
+    ///
+    /// ### Example
+    /// ```
+    /// Str("{}, {}").format(1, 2); // "1, 2"
+    /// Str("{1}{0}{1}").format("a", "b"); // "bab"
+    /// Str("{:08.3f}|{:<5}|{:^7b}|{:+}").format(3.14159, "ab", 5, 42); // "0003.142|ab   |  101  |+42"
+    /// ```
     template <typename... Args>
     Str format(const Args&... args) const
     {
-        std::ostringstream oss;
-        std::string_view str(str_);
-        (format_helper(oss, str, args), ...);
-        oss << str;
-        return oss.str();
+        std::string buffer;
+        buffer.reserve(size() + 8 * sizeof...(Args));
+        append_formatted(buffer, chars(), args...);
+        return buffer;
     }
 
     /*
@@ -722,26 +3566,228 @@ public:
     /// Output the string to the specified output stream.
     friend std::ostream& operator<<(std::ostream& os, const Str& string)
     {
-        return os << '"' << string.str_ << '"';
+        return os << '"' << string.chars() << '"';
     }
 
     /// Get a line of string from the specified input stream.
     friend std::istream& operator>>(std::istream& is, Str& string)
     {
-        return std::getline(is, string.str_);
+        std::string line;
+        std::getline(is, line);
+        string = std::move(line);
+        return is;
     }
 
     friend struct std::hash<pyincpp::Str>;
+    friend class StrBuilder;
+};
+
+/// StrBuilder is mutable buffer for building a string piece by piece in amortized O(1) per character.
+///
+/// ### Example
+/// ```
+/// StrBuilder builder;
+/// builder.append("x = ").append(1).append(", ").append_format("y = {}", 2.5);
+/// builder.to_str(); // "x = 1, y = 2.5"
+/// ```
+class StrBuilder
+{
+private:
+    // Buffer.
+    std::string buffer_;
+
+public:
+    /*
+     * Constructor
+     */
+
+    /// Create an empty builder.
+    StrBuilder() = default;
+
+    /// Create an empty builder with room for `capacity` characters.
+    explicit StrBuilder(int capacity)
+    {
+        reserve(capacity);
+    }
+
+    /*
+     * Examination
+     */
+
+    /// Return the number of characters in the builder.
+    int size() const
+    {
+        return buffer_.size();
+    }
+
+    /// Return true if the builder contains no characters.
+    bool is_empty() const
+    {
+        return buffer_.empty();
+    }
+
+    /// Return the number of characters that can be held without reallocation.
+    int capacity() const
+    {
+        return buffer_.capacity();
+    }
+
+    /*
+     * Manipulation
+     */
+
+    /// Reserve room for at least `capacity` characters.
+    StrBuilder& reserve(int capacity)
+    {
+        if (capacity < 0)
+        {
+            throw std::runtime_error("Error: Require capacity >= 0 for reserve(capacity).");
+        }
+
+        buffer_.reserve(capacity);
+        return *this;
+    }
+
+    /// Remove all characters, keeping the capacity.
+    StrBuilder& clear()
+    {
+        buffer_.clear();
+        return *this;
+    }
+
+    /// Append the specified `string`.
+    StrBuilder& append(const Str& string)
+    {
+        buffer_ += string.chars();
+        return *this;
+    }
+
+    /// Append the specified characters.
+    StrBuilder& append(std::string_view chars)
+    {
+        buffer_ += chars;
+        return *this;
+    }
+
+    /// Append the specified null-terminated characters.
+    StrBuilder& append(const char* chars)
+    {
+        buffer_ += chars;
+        return *this;
+    }
+
+    /// Append the specified character.
+    StrBuilder& append(char ch)
+    {
+        buffer_ += ch;
+        return *this;
+    }
+
+    /// Append the boolean as "1" or "0", the same as `append_format("{}", boolean)`.
+    StrBuilder& append(bool boolean)
+    {
+        buffer_ += boolean ? '1' : '0';
+        return *this;
+    }
+
+    /// Append the decimal representation of a primitive integer, without allocation.
+    template <std::integral T>
+        requires(!std::is_same_v<T, bool>)
+    StrBuilder& append(T number)
+    {
+        char chars[24]; // ULLONG_MAX has 20 digits
+        auto [ptr, ec] = std::to_chars(chars, chars + sizeof(chars), number);
+        buffer_.append(chars, ptr);
+        return *this;
+    }
+
+    /// Append the shortest representation of a floating-point number that round trips, without allocation.
+    template <std::floating_point T>
+    StrBuilder& append(T number)
+    {
+        char chars[32];
+        auto [ptr, ec] = std::to_chars(chars, chars + sizeof(chars), number);
+        buffer_.append(chars, ptr);
+        return *this;
+    }
+
+    /// Append the integer.
+    StrBuilder& append(const Int& integer)
+    {
+        int offset = buffer_.size();
+        buffer_.resize(offset + integer.digits() + 1); // digits + sign
+        auto [ptr, ec] = integer.to_chars(buffer_.data() + offset, buffer_.data() + buffer_.size());
+        buffer_.resize(ptr - buffer_.data());
+        return *this;
+    }
+
+    /// Format `args` according to the format string checked at compile time, and append the result in place.
+    /// See `Str::format` for the syntax of the format string.
+    ///
+    /// ### Example
+    /// ```
+    /// StrBuilder().append_format("{} + {} = {:.1f}", 1, 2, 3.0).to_str(); // "1 + 2 = 3.0"
+    /// ```
+    template <typename... Args>
+    StrBuilder& append_format(Str::Format<std::type_identity_t<Args>...> format, const Args&... args)
+    {
+        if (!format.sequential_) // indexed fields, checked at compile time
+        {
+            Str::append_formatted(buffer_, format.str_, args...);
+            return *this;
+        }
+
+        std::size_t pos = 0;
+        std::size_t index = 0;
+        [[maybe_unused]] auto append_field = [&](const auto& arg) // unused if there is no argument
+        {
+            const auto& field = format.fields_[index++];
+            if (field.found)
+            {
+                Str::append_literal(buffer_, format.str_.substr(pos, field.literal_end - pos), field.escaped);
+                Str::format_value(buffer_, arg, field.spec);
+                pos = field.next;
+            }
+        };
+        (append_field(args), ...);
+        Str::append_literal(buffer_, format.str_.substr(pos), format.tail_.escaped);
+        return *this;
+    }
+
+    /*
+     * Production
+     */
+
+    /// Return the built string.
+    Str to_str() const&
+    {
+        return buffer_;
+    }
+
+    /// Return the built string, taking over the buffer of the builder.
+    Str to_str() &&
+    {
+        return std::move(buffer_);
+    }
 };
 
 } // namespace pyincpp
 
+template <>
+struct std::hash<pyincpp::StrView> // explicit specialization
+{
+    std::size_t operator()(const pyincpp::StrView& view) const
+    {
+        return std::hash<std::string_view>{}(view.view()); // same as the hash of Str
+    }
+};
+
 template <>
 struct std::hash<pyincpp::Str> // explicit specialization
 {
     std::size_t operator()(const pyincpp::Str& string) const
     {
-        return std::hash<std::string>{}(string.str_);
+        return string.hash();
     }
 };
 
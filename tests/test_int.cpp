@@ -37,6 +37,47 @@ TEST_CASE("Int")
         // ~Int()
     }
 
+    SECTION("copy_on_write")
+    {
+        Int a = "123456789123456789123456789";
+        Int b = a;
+        Int c = -a;
+        Int d = c.abs();
+
+        ++b;
+        REQUIRE(a == Int("123456789123456789123456789"));
+        REQUIRE(b == Int("123456789123456789123456790"));
+        c *= 2;
+        REQUIRE(a == Int("123456789123456789123456789"));
+        REQUIRE(c == Int("-246913578246913578246913578"));
+        d -= d;
+        REQUIRE(d.is_zero());
+        REQUIRE(a == Int("123456789123456789123456789"));
+
+        Int e = a;
+        e /= 3;
+        e %= 1000;
+        a += e;
+        REQUIRE(e == 263);
+        REQUIRE(a == Int("123456789123456789123457052"));
+        REQUIRE(b == Int("123456789123456789123456790"));
+    }
+
+    SECTION("literal")
+    {
+        REQUIRE(0_i == 0);
+        REQUIRE((0_i).is_zero());
+        REQUIRE(123_i == 123);
+        REQUIRE(-123_i == -123);
+        REQUIRE(123456789012345678901234567890_i == Int("123456789012345678901234567890"));
+        REQUIRE(1'000'000'000'000_i == Int("1000000000000"));
+        REQUIRE(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF_i == Int("340282366920938463463374607431768211455"));
+        REQUIRE(0b1'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0000'0001_i == Int("18446744073709551617"));
+        REQUIRE(0777_i == 511);
+        REQUIRE(00_i == 0);
+        REQUIRE(std::is_same_v<decltype(1_i), Int>);
+    }
+
     Int zero;
     Int positive = "18446744073709551617";  // 2^64+1
     Int negative = "-18446744073709551617"; // -(2^64+1)
@@ -262,6 +303,79 @@ TEST_CASE("Int")
         }
     }
 
+    SECTION("primitive")
+    {
+        // operator+-*/% with primitive integer
+        REQUIRE(positive + 1 == "18446744073709551618");
+        REQUIRE(positive - 1 == "18446744073709551616");
+        REQUIRE(positive * 7 == "129127208515966861319");
+        REQUIRE(positive / 7 == "2635249153387078802");
+        REQUIRE(positive % 7 == 3);
+        REQUIRE(negative % 7 == -3);
+        REQUIRE(negative % -7 == -3);
+        REQUIRE(positive % 1000000007 == 582344009);
+        REQUIRE(Int(-5) + 5 == 0);
+        REQUIRE(Int(5) - 6 == -1);
+        REQUIRE(Int(-5) - 5u == -10);
+        REQUIRE(Int("1000000000") - 1 == "999999999");
+        REQUIRE(Int("999999999") + 1 == "1000000000");
+        REQUIRE(Int(LLONG_MIN) == LLONG_MIN);
+        REQUIRE(Int(ULLONG_MAX) == ULLONG_MAX);
+        REQUIRE(zero + LLONG_MIN == "-9223372036854775808");
+        REQUIRE(zero - LLONG_MIN == "9223372036854775808");
+        REQUIRE(zero + ULLONG_MAX == "18446744073709551615");
+        REQUIRE(positive - ULLONG_MAX == 2);
+        REQUIRE(Int(2) - ULLONG_MAX == "-18446744073709551613");
+        REQUIRE(positive * ULLONG_MAX == "340282366920938463463374607431768211455");
+        REQUIRE(positive / ULLONG_MAX == 1);
+        REQUIRE(positive % ULLONG_MAX == 2);
+        REQUIRE(positive * 0 == 0);
+        REQUIRE(zero * 5 == 0);
+        REQUIRE_THROWS_MATCHES(positive / 0, std::runtime_error, Message("Error: Divide by zero."));
+        REQUIRE_THROWS_MATCHES(positive % 0, std::runtime_error, Message("Error: Divide by zero."));
+
+        // compare with primitive integer
+        REQUIRE(zero == 0);
+        REQUIRE(positive != 1);
+        REQUIRE(positive > ULLONG_MAX);
+        REQUIRE(negative < LLONG_MIN);
+        REQUIRE(Int(-3) < 2);
+        REQUIRE(Int(-3) < -2);
+        REQUIRE(Int(3) >= 3u);
+        REQUIRE(2 > Int(-3));
+        REQUIRE(0 == zero);
+
+        // against Int arithmetic
+        long long values[] = {0, 1, -1, 7, -7, 999999999, 1000000000, -1000000007, 12345678901LL, -98765432109876LL, LLONG_MAX, LLONG_MIN};
+        for (const Int& a : {zero, positive, negative, Int(123), Int(-1000000000), Int("-98765432109876")})
+        {
+            for (long long b : values)
+            {
+                REQUIRE(a + b == a + Int(b));
+                REQUIRE(a - b == a - Int(b));
+                REQUIRE(a * b == a * Int(b));
+                REQUIRE((a == b) == (a == Int(b)));
+                REQUIRE((a < b) == (a < Int(b)));
+                REQUIRE((a > b) == (a > Int(b)));
+                if (b != 0)
+                {
+                    REQUIRE(a / b == a / Int(b));
+                    REQUIRE(a % b == a % Int(b));
+                    REQUIRE(a.divmod(b) == a.divmod(Int(b)));
+                }
+            }
+        }
+
+        // counter
+        Int counter;
+        for (int i = 0; i < 1000; ++i)
+        {
+            counter += i;
+            counter -= 1;
+        }
+        REQUIRE(counter == 499500 - 1000);
+    }
+
     SECTION("factorial")
     {
         // (negative)! throws exception
@@ -318,6 +432,64 @@ TEST_CASE("Int")
         REQUIRE(Int("-2147483648").to_number<double>() == -2147483648.0);
     }
 
+    SECTION("to_double")
+    {
+        REQUIRE(Int().to_double() == 0.0);
+        REQUIRE(Int(-42).to_double() == -42.0);
+        REQUIRE(Int("9007199254740993").to_double() == 9007199254740992.0); // ties to even
+        REQUIRE(Int("9007199254740995").to_double() == 9007199254740996.0);
+        REQUIRE(Int("18446744073709551617").to_double() == 18446744073709551616.0);
+        REQUIRE(Int("123456789012345678901234567890").to_double() == 1.2345678901234568e+29);
+        REQUIRE(Int("-123456789012345678901234567890").to_double() == -1.2345678901234568e+29);
+        REQUIRE((Int::pow(10, 300) + 1).to_double() == 1e300);
+        REQUIRE(Int::pow(10, 308).to_double() == 1e308);
+        REQUIRE(Int::from_double(std::numeric_limits<double>::max()).to_double() == std::numeric_limits<double>::max());
+
+        REQUIRE_THROWS_MATCHES(Int::pow(10, 309).to_double(), std::overflow_error, Message("Error: Int too large to convert to double."));
+        REQUIRE_THROWS_MATCHES(Int::pow(10, 400).to_double(), std::overflow_error, Message("Error: Int too large to convert to double."));
+    }
+
+    SECTION("from_double")
+    {
+        REQUIRE(Int::from_double(0.0) == 0);
+        REQUIRE(Int::from_double(-0.0) == 0);
+        REQUIRE(Int::from_double(0.99) == 0);
+        REQUIRE(Int::from_double(-1.5) == -1);
+        REQUIRE(Int::from_double(9007199254740992.0) == "9007199254740992");
+        REQUIRE(Int::from_double(1e100) == "10000000000000000159028911097599180468360808563945281389781327557747838772170381060813469985856815104");
+        REQUIRE(Int::from_double(-1.5e300) % 1000000007 == 989050168 - 1000000007);
+        REQUIRE(Int::from_double(-1.5e300).digits() == 301);
+        for (double d : {1.0, -3.25, 12345.678, 1e18, -1e19, 3.14e150, 1e308})
+        {
+            REQUIRE(Int::from_double(d).to_double() == std::trunc(d));
+        }
+
+        REQUIRE_THROWS_MATCHES(Int::from_double(std::nan("")), std::runtime_error, Message("Error: Cannot convert NaN to Int."));
+        REQUIRE_THROWS_MATCHES(Int::from_double(INFINITY), std::overflow_error, Message("Error: Cannot convert infinity to Int."));
+    }
+
+    SECTION("frexp_ldexp")
+    {
+        REQUIRE(Int().frexp() == std::pair<double, long long>(0.0, 0));
+        REQUIRE(Int(1).frexp() == std::pair<double, long long>(0.5, 1));
+        REQUIRE(Int(-3).frexp() == std::pair<double, long long>(-0.75, 2));
+        REQUIRE(Int("18446744073709551617").frexp() == std::pair<double, long long>(0.5, 65));
+
+        auto [m1, e1] = Int::pow(3, 5000).frexp();
+        REQUIRE(m1 == Approx(0.8781282749222807).epsilon(1e-13));
+        REQUIRE(e1 == 7925);
+        auto [m2, e2] = (-(Int::pow(7, 3000) + 12345)).frexp();
+        REQUIRE(m2 == Approx(-0.5229577037913511).epsilon(1e-13));
+        REQUIRE(e2 == 8423);
+
+        REQUIRE(Int::ldexp(0.5, 1) == 1);
+        REQUIRE(Int::ldexp(0.5, 0) == 0);
+        REQUIRE(Int::ldexp(-0.75, 1) == -1);
+        REQUIRE(Int::ldexp(0.75, 2000) == Int::pow(2, 1998) * 3);
+        REQUIRE(Int::ldexp(1, -100) == 0);
+        REQUIRE(Int::ldexp(m1, e1).digits() == Int::pow(3, 5000).digits());
+    }
+
     SECTION("sqrt")
     {
         REQUIRE_THROWS_MATCHES(Int::sqrt("-1"), std::runtime_error, Message("Error: Require n >= 0 for sqrt(n)."));
@@ -395,6 +567,165 @@ TEST_CASE("Int")
         REQUIRE(Int::log(positive * 2, 2) == 65);     // integer: 2^65+2
 
         REQUIRE(Int::log("123456789000", 233) == 4); // 4.6851911360933745
+
+        REQUIRE(Int::log(Int::pow(2, 5000), 2) == 5000);
+        REQUIRE(Int::log(Int::pow(2, 5000) - 1, 2) == 4999);
+        REQUIRE(Int::log(Int::pow(2, 5000), 8) == 1666);
+        REQUIRE(Int::log(Int::pow(10, 1000), "18446744073709551616") == 51); // 2^64
+        REQUIRE(Int::log(Int::pow(3, 5000), 3) == 5000);
+        REQUIRE(Int::log(Int::pow(3, 5000) - 1, 3) == 4999);
+        REQUIRE(Int::log(Int::pow(7, 3000) + 5, 49) == 1500);
+        REQUIRE(Int::log(Int::pow(10, 1000), 7) == 1183);
+        REQUIRE(Int::log(Int::pow(10, 1000), "12345678901234567890123") == 45);
+        REQUIRE(Int::log(5, "12345678901234567890123") == 0);
+    }
+
+    SECTION("bit_length")
+    {
+        REQUIRE(zero.bit_length() == 0);
+        REQUIRE(Int(1).bit_length() == 1);
+        REQUIRE(Int(-8).bit_length() == 4);
+        REQUIRE(Int("18446744073709551615").bit_length() == 64); // rounds to 2^64 as double
+        REQUIRE(positive.bit_length() == 65);
+        REQUIRE(negative.bit_length() == 65);
+        REQUIRE(Int::pow(2, 5000).bit_length() == 5001);
+        REQUIRE((Int::pow(2, 5000) - 1).bit_length() == 5000);
+        REQUIRE(Int::pow(10, 400).bit_length() == 1329);
+
+        // frexp() has a relative error about 4.5e-13 at this size, so only the exact comparison can tell them apart
+        Int huge = Int::pow(2, 2'000'000);
+        REQUIRE(huge.bit_length() == 2'000'001);
+        REQUIRE((huge - 1).bit_length() == 2'000'000);
+        REQUIRE(Int::log(huge - 1, 2) == 1'999'999);
+    }
+
+    SECTION("sum_product_dot")
+    {
+        // sum()
+        REQUIRE(Int::sum(std::vector<Int>{}) == 0);
+        REQUIRE(Int::sum(std::vector<Int>{positive, negative}) == 0);
+        REQUIRE(Int::sum(std::vector<Int>{positive, positive, 1}) == "36893488147419103235");
+        REQUIRE(Int::sum(std::vector<Int>{negative, 1, "-999999999"}) == "-18446744074709551615");
+        REQUIRE(Int::sum(std::vector<int>{1, 2, 3, -4}) == 2);
+
+        std::vector<Int> numbers;
+        Int expected_sum;
+        for (int i = 0; i < 1000; ++i)
+        {
+            numbers.push_back(Int::pow(-3, i) + 999999999);
+            expected_sum += numbers.back();
+        }
+        REQUIRE(Int::sum(numbers) == expected_sum);
+
+        // product()
+        REQUIRE(Int::product(std::vector<Int>{}) == 1);
+        REQUIRE(Int::product(std::vector<Int>{positive}) == positive);
+        REQUIRE(Int::product(std::vector<Int>{positive, negative}) == "-340282366920938463500268095579187314689");
+        REQUIRE(Int::product(std::vector<Int>{positive, zero, negative}) == 0);
+        REQUIRE(Int::product(std::vector<int>{-1, -2, -3}) == -6);
+
+        std::vector<int> one_to_hundred(100);
+        std::iota(one_to_hundred.begin(), one_to_hundred.end(), 1);
+        REQUIRE(Int::product(one_to_hundred) == Int(100).factorial());
+
+        // dot()
+        REQUIRE(Int::dot(std::vector<Int>{}, std::vector<Int>{}) == 0);
+        REQUIRE(Int::dot(std::vector<Int>{1, 2, 3}, std::vector<Int>{4, 5, 6}) == 32);
+        REQUIRE(Int::dot(std::vector<Int>{positive, negative}, std::vector<int>{2, 3}) == negative);
+        REQUIRE(Int::dot(std::vector<int>{INT_MAX, INT_MAX}, std::vector<int>{INT_MAX, INT_MAX}) == Int(INT_MAX) * INT_MAX * 2);
+        REQUIRE_THROWS_MATCHES(Int::dot(std::vector<Int>{1, 2}, std::vector<Int>{1}), std::runtime_error, Message("Error: Require the same length for dot(a, b)."));
+    }
+
+    SECTION("comb_perm_multinomial")
+    {
+        // comb()
+        REQUIRE(Int::comb(0, 0) == 1);
+        REQUIRE(Int::comb(5, 2) == 10);
+        REQUIRE(Int::comb(5, 6) == 0);
+        REQUIRE(Int::comb(100, 50) == "100891344545564193334812497256");
+        REQUIRE(Int::comb(1000, 500) == Int(1000).factorial() / (Int(500).factorial() * Int(500).factorial()));
+        REQUIRE(Int::comb(INT_MAX, 1) == INT_MAX);
+        REQUIRE(Int::comb(INT_MAX, INT_MAX - 2) == Int(INT_MAX) * (INT_MAX - 1) / 2);
+        REQUIRE_THROWS_MATCHES(Int::comb(-1, 0), std::runtime_error, Message("Error: Require 0 <= n <= INT_MAX and k >= 0 for comb(n, k)."));
+        REQUIRE_THROWS_MATCHES(Int::comb(1, -1), std::runtime_error, Message("Error: Require 0 <= n <= INT_MAX and k >= 0 for comb(n, k)."));
+        REQUIRE_THROWS_MATCHES(Int::comb("2147483648", 1), std::runtime_error, Message("Error: Require 0 <= n <= INT_MAX and k >= 0 for comb(n, k)."));
+
+        // perm()
+        REQUIRE(Int::perm(0, 0) == 1);
+        REQUIRE(Int::perm(5, 2) == 20);
+        REQUIRE(Int::perm(5, 6) == 0);
+        REQUIRE(Int::perm(100, 100) == Int(100).factorial());
+        REQUIRE(Int::perm(300, 150) == Int(300).factorial() / Int(150).factorial());
+        REQUIRE(Int::perm(INT_MAX, 2) == Int(INT_MAX) * (INT_MAX - 1));
+        REQUIRE_THROWS_MATCHES(Int::perm(3, -1), std::runtime_error, Message("Error: Require 0 <= n <= INT_MAX and k >= 0 for perm(n, k)."));
+
+        // multinomial()
+        REQUIRE(Int::multinomial(std::vector<Int>{}) == 1);
+        REQUIRE(Int::multinomial(std::vector<Int>{2, 1, 1}) == 12);
+        REQUIRE(Int::multinomial(std::vector<int>{100, 50}) == Int::comb(150, 50));
+        REQUIRE(Int::multinomial(std::vector<int>{30, 20, 10}) == Int(60).factorial() / Int(30).factorial() / Int(20).factorial() / Int(10).factorial());
+        REQUIRE(Int::multinomial(std::vector<int>{INT_MAX - 3, 2, 1}) == Int::comb(INT_MAX, 3) * 6 / 2);
+        REQUIRE_THROWS_MATCHES(Int::multinomial(std::vector<int>{1, -1}), std::runtime_error, Message("Error: Require k >= 0 and sum(k) <= INT_MAX for multinomial(ks)."));
+        REQUIRE_THROWS_MATCHES(Int::multinomial(std::vector<int>{INT_MAX, 1}), std::runtime_error, Message("Error: Require k >= 0 and sum(k) <= INT_MAX for multinomial(ks)."));
+    }
+
+    SECTION("parallel_mul")
+    {
+        Int a = Int::pow(3, 20000) + 1;
+        Int b = Int::pow(7, 12000) - 1;
+        Int expected = a * b;
+        Int square = a * a;
+
+        REQUIRE(Int::threads() == 1);
+        Int::set_threads(4);
+        REQUIRE(Int::threads() == 4);
+        REQUIRE(a * b == expected);
+        REQUIRE(b * a == expected);
+        REQUIRE(-a * b == -expected);
+        REQUIRE(a * a == square);
+        REQUIRE(Int(3) * 5 == 15);
+        REQUIRE(a * b == expected); // workers are reused
+        Int::set_threads(1);
+
+        // concurrent callers share the workers
+        std::vector<std::thread> callers;
+        std::vector<Int> products(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            callers.emplace_back([&, i]()
+                                 {
+                                     Int::set_threads(3);
+                                     products[i] = a * b;
+                                 });
+        }
+        for (auto& caller : callers)
+        {
+            caller.join();
+        }
+        for (const auto& product : products)
+        {
+            REQUIRE(product == expected);
+        }
+
+        REQUIRE_THROWS_MATCHES(Int::set_threads(0), std::runtime_error, Message("Error: Require n >= 1 for set_threads(n)."));
+    }
+
+    SECTION("divexact")
+    {
+        REQUIRE(Int::divexact(0, 7) == 0);
+        REQUIRE(Int::divexact(42, 7) == 6);
+        REQUIRE(Int::divexact(-42, 7) == -6);
+        REQUIRE(Int::divexact(42, -42) == -1);
+        REQUIRE(Int::divexact(Int::pow(10, 30) * 7, 7) == Int::pow(10, 30));
+        REQUIRE(Int::divexact(Int::pow(10, 30), Int::pow(2, 30)) == Int::pow(5, 30));
+        REQUIRE(Int::divexact(positive * negative, negative) == positive);
+        REQUIRE_THROWS_MATCHES(Int::divexact(1, 0), std::runtime_error, Message("Error: Divide by zero."));
+
+        Int a = Int::pow(3, 500) * Int::pow(2, 100) + 12345;
+        Int b = Int::pow(7, 300) * Int::pow(10, 20) - 1;
+        REQUIRE(Int::divexact(a * b, b) == a);
+        REQUIRE(Int::divexact(a * b, a) == b);
+        REQUIRE(Int::divexact(a * b * 1000, -b * 40) == -a * 25);
     }
 
     SECTION("gcd_lcm")
@@ -564,6 +895,117 @@ TEST_CASE("Int")
         REQUIRE(zero.to_string() == "0");
         REQUIRE(positive.to_string() == "18446744073709551617");
         REQUIRE(negative.to_string() == "-18446744073709551617");
+
+        REQUIRE(zero.to_string(2) == "0");
+        REQUIRE(positive.to_string(16) == "10000000000000001");
+        REQUIRE(negative.to_string(8) == "-2000000000000000000001");
+        REQUIRE(negative.to_string(32) == "-g000000000001");
+        REQUIRE(Int(-255).to_string(2) == "-11111111");
+        REQUIRE(Int("1000000000").to_string(7) == "33531600616");
+        REQUIRE(Int(35).to_string(36) == "z");
+        REQUIRE_THROWS_MATCHES(zero.to_string(37), std::runtime_error, Message("Error: Require 2 <= base <= 36 for to_string(base)."));
+
+        // round trip through the binary words
+        Int big = Int::pow(3, 1000) * -7;
+        for (int base = 2; base <= 36; ++base)
+        {
+            Int value;
+            std::string str = big.to_string(base);
+            Int::from_chars(str.data(), str.data() + str.size(), value, base);
+            REQUIRE(value == big);
+        }
+
+        REQUIRE(zero.hex() == "0x0");
+        REQUIRE(Int(255).hex() == "0xff");
+        REQUIRE(Int(-255).hex() == "-0xff");
+        REQUIRE(Int(5).bin() == "0b101");
+        REQUIRE(Int(-8).oct() == "-0o10");
+        REQUIRE(positive.hex() == "0x10000000000000001");
+    }
+
+    SECTION("to_chars")
+    {
+        char buf[64];
+        auto to_chars = [&](const Int& integer, int base = 10)
+        {
+            auto [ptr, ec] = integer.to_chars(buf, buf + 64, base);
+            REQUIRE(ec == std::errc());
+            return std::string(buf, ptr);
+        };
+
+        REQUIRE(to_chars(zero) == "0");
+        REQUIRE(to_chars(positive) == "18446744073709551617");
+        REQUIRE(to_chars(negative) == "-18446744073709551617");
+        REQUIRE(to_chars(Int("1000000000000000001")) == "1000000000000000001");
+
+        REQUIRE(to_chars(zero, 16) == "0");
+        REQUIRE(to_chars(Int(255), 16) == "ff");
+        REQUIRE(to_chars(Int(-255), 2) == "-11111111");
+        REQUIRE(to_chars(Int(35), 36) == "z");
+        REQUIRE(to_chars(positive, 16) == "10000000000000001");
+        REQUIRE(to_chars(negative, 8) == "-2000000000000000000001");
+        REQUIRE(to_chars(Int("1000000000"), 7) == "33531600616");
+
+        // value too large
+        REQUIRE(positive.to_chars(buf, buf + 19).ec == std::errc::value_too_large);
+        REQUIRE(negative.to_chars(buf, buf + 20).ec == std::errc::value_too_large);
+        REQUIRE(positive.to_chars(buf, buf + 16, 16).ec == std::errc::value_too_large);
+        REQUIRE(zero.to_chars(buf, buf).ec == std::errc::value_too_large);
+        REQUIRE(positive.to_chars(buf, buf + 20).ec == std::errc());
+    }
+
+    SECTION("from_chars")
+    {
+        auto from_chars = [](std::string_view sv, Int& value, int base = 10)
+        {
+            return Int::from_chars(sv.data(), sv.data() + sv.size(), value, base);
+        };
+
+        Int value = 42;
+        REQUIRE(from_chars("18446744073709551617", value).ec == std::errc());
+        REQUIRE(value == positive);
+        REQUIRE(from_chars("-18446744073709551617", value).ec == std::errc());
+        REQUIRE(value == negative);
+        REQUIRE(from_chars("0000000000000000000", value).ec == std::errc());
+        REQUIRE(value == zero);
+        REQUIRE(from_chars("-0", value).ec == std::errc());
+        REQUIRE(value == zero);
+
+        REQUIRE(from_chars("ffffffffffffffff", value, 16).ec == std::errc());
+        REQUIRE(value == Int("18446744073709551615"));
+        REQUIRE(from_chars("-CafeBabe", value, 16).ec == std::errc());
+        REQUIRE(value == Int("-3405691582"));
+        REQUIRE(from_chars("00101", value, 2).ec == std::errc());
+        REQUIRE(value == 5);
+        REQUIRE(from_chars("zz", value, 36).ec == std::errc());
+        REQUIRE(value == 35 * 36 + 35);
+
+        // stop at the first invalid character
+        std::string_view sv = "123abc";
+        auto [ptr, ec] = Int::from_chars(sv.data(), sv.data() + sv.size(), value);
+        REQUIRE(ec == std::errc());
+        REQUIRE(ptr == sv.data() + 3);
+        REQUIRE(value == 123);
+
+        // invalid argument, value unmodified
+        REQUIRE(from_chars("", value).ec == std::errc::invalid_argument);
+        REQUIRE(from_chars("-", value).ec == std::errc::invalid_argument);
+        REQUIRE(from_chars("+1", value).ec == std::errc::invalid_argument);
+        REQUIRE(from_chars(" 1", value).ec == std::errc::invalid_argument);
+        REQUIRE(from_chars("2", value, 2).ec == std::errc::invalid_argument);
+        REQUIRE(from_chars("1", value, 37).ec == std::errc::invalid_argument);
+        REQUIRE(value == 123);
+
+        // round trip
+        for (int base = 2; base <= 36; ++base)
+        {
+            char buf[256];
+            Int n = Int::pow(-7, 77);
+            auto [ptr, ec] = n.to_chars(buf, buf + 256, base);
+            REQUIRE(ec == std::errc());
+            REQUIRE(Int::from_chars(buf, ptr, value, base).ptr == ptr);
+            REQUIRE(value == n);
+        }
     }
 
     SECTION("input")
@@ -0,0 +1,171 @@
+#include "../sources/modint.hpp"
+
+#include "tool.hpp"
+
+using namespace pyincpp;
+
+TEST_CASE("ModInt")
+{
+    SECTION("basics")
+    {
+        // ModInt(T value = 0)
+        ModInt<7> m1;
+        REQUIRE(m1.value() == 0);
+        REQUIRE(m1.modulus() == 7);
+        REQUIRE(m1.is_zero());
+        ModInt<7> m2(10);
+        REQUIRE(m2.value() == 3);
+        ModInt<7> m3(-10);
+        REQUIRE(m3.value() == 4);
+        REQUIRE(ModInt<7>(LLONG_MIN).value() == Int(LLONG_MIN) % 7 + 7);
+
+        // ModInt(const Int& value)
+        ModInt<1'000'000'007> m4(Int("18446744073709551617"));
+        REQUIRE(m4.value() == 582344009);
+        ModInt<1'000'000'007> m5(Int("-18446744073709551617"));
+        REQUIRE(m5.value() == 1'000'000'007 - 582344009);
+
+        // ModInt(const Int& value, const Int& modulus)
+        ModInt<> m6(10, 7);
+        REQUIRE(m6.value() == 3);
+        REQUIRE(m6.modulus() == 7);
+        ModInt<> m7(-1, "18446744073709551617");
+        REQUIRE(m7.value() == "18446744073709551616");
+        REQUIRE(m7.modulus() == "18446744073709551617");
+        REQUIRE_THROWS_MATCHES(ModInt<>(1, 1), std::runtime_error, Message("Error: Require modulus > 1."));
+        REQUIRE_THROWS_MATCHES(ModInt<>(1, -7), std::runtime_error, Message("Error: Require modulus > 1."));
+
+        // ModInt(const ModInt& that)
+        ModInt<> m8(m7);
+        REQUIRE(m8 == m7);
+
+        // ModInt(ModInt&& that)
+        ModInt<> m9(std::move(m8));
+        REQUIRE(m9 == m7);
+    }
+
+    SECTION("compare")
+    {
+        REQUIRE(ModInt<7>(3) == ModInt<7>(10));
+        REQUIRE(ModInt<7>(3) != ModInt<7>(4));
+        REQUIRE(ModInt<>(3, 7) == ModInt<>(10, 7));
+        REQUIRE(ModInt<>(3, 7) != ModInt<>(3, 8));
+        REQUIRE(ModInt<>(3, "18446744073709551617") != ModInt<>(3, 7));
+    }
+
+    SECTION("arithmetic")
+    {
+        // compare with Int arithmetic for every kind of modulus
+        auto check = [](const Int& modulus, auto make)
+        {
+            Int values[] = {0, 1, 2, -1, 123456789, "-98765432109876543210", "18446744073709551617", modulus - 1};
+            for (const Int& a : values)
+            {
+                for (const Int& b : values)
+                {
+                    auto x = make(a), y = make(b);
+                    auto norm = [&](const Int& n)
+                    {
+                        Int r = n % modulus;
+                        return r.is_negative() ? r + modulus : r;
+                    };
+                    REQUIRE((x + y).value() == norm(a + b));
+                    REQUIRE((x - y).value() == norm(a - b));
+                    REQUIRE((x * y).value() == norm(a * b));
+                    REQUIRE((-x).value() == norm(-a));
+                    REQUIRE((+x).value() == norm(a));
+                    if (Int::gcd(norm(b), modulus) == 1)
+                    {
+                        REQUIRE((x / y * y) == x);
+                    }
+                }
+            }
+        };
+
+        // Montgomery
+        check(1'000'000'007, [](const Int& n)
+              { return ModInt<1'000'000'007>(n); });
+        check(998'244'353, [](const Int& n)
+              { return ModInt<998'244'353>(n); });
+        check(3, [](const Int& n)
+              { return ModInt<>(n, 3); });
+        check("2305843009213693951", [](const Int& n) // 2^61 - 1
+              { return ModInt<>(n, "2305843009213693951"); });
+
+        // native, even or >= half the word
+        check(1'000'000, [](const Int& n)
+              { return ModInt<1'000'000>(n); });
+        check(4'294'967'291u, [](const Int& n)
+              { return ModInt<4'294'967'291u>(n); });
+        check(1'000'000, [](const Int& n)
+              { return ModInt<>(n, 1'000'000); });
+        check("4611686018427387904", [](const Int& n) // 2^62
+              { return ModInt<>(n, "4611686018427387904"); });
+        check("18446744073709551557", [](const Int& n) // 2^64 - 59
+              { return ModInt<>(n, "18446744073709551557"); });
+
+        // Int
+        check("18446744073709551616", [](const Int& n)
+              { return ModInt<>(n, "18446744073709551616"); });
+
+        // different moduli
+        REQUIRE_THROWS_MATCHES(ModInt<>(1, 7) + ModInt<>(1, 8), std::runtime_error, Message("Error: Require the same modulus."));
+        REQUIRE_THROWS_MATCHES(ModInt<>(1, 7) * ModInt<>(1, "18446744073709551617"), std::runtime_error, Message("Error: Require the same modulus."));
+
+        // compound assignment
+        ModInt<13> m = 5;
+        m += 10;
+        REQUIRE(m == 2);
+        m -= 3;
+        REQUIRE(m == 12);
+        m *= 12;
+        REQUIRE(m == 1);
+        m /= 2;
+        REQUIRE(m == 7);
+    }
+
+    SECTION("inverse")
+    {
+        REQUIRE(ModInt<7>(3).inverse() == 5);
+        REQUIRE(ModInt<1'000'000'007>(2).inverse() == 500'000'004);
+        REQUIRE(ModInt<>(3, 10).inverse().value() == 7);
+        REQUIRE(ModInt<>(3, "18446744073709551617").inverse().value() == "6148914691236517206");
+
+        REQUIRE_THROWS_MATCHES(ModInt<7>(0).inverse(), std::runtime_error, Message("Error: Base is not invertible for the given modulus."));
+        REQUIRE_THROWS_MATCHES(ModInt<10>(4).inverse(), std::runtime_error, Message("Error: Base is not invertible for the given modulus."));
+        REQUIRE_THROWS_MATCHES(ModInt<>(2, "18446744073709551616").inverse(), std::runtime_error, Message("Error: Base is not invertible for the given modulus."));
+        REQUIRE_THROWS_MATCHES(ModInt<10>(1) / ModInt<10>(5), std::runtime_error, Message("Error: Base is not invertible for the given modulus."));
+    }
+
+    SECTION("pow")
+    {
+        REQUIRE(ModInt<7>::pow(3, 0) == 1);
+        REQUIRE(ModInt<7>::pow(0, 0) == 1);
+        REQUIRE(ModInt<100>::pow(1024, 1024) == 76);
+        REQUIRE(ModInt<100>::pow(9999, 1001) == 99);
+        REQUIRE(ModInt<1'000'000'007>::pow(2, -1) == 500'000'004);
+        REQUIRE(ModInt<1'000'000'007>::pow(2, 1'000'000'006) == 1); // Fermat's little theorem
+        REQUIRE(ModInt<1'000'000'007>::pow(3, "123456789123456789").value() == Int::pow(3, "123456789123456789", 1'000'000'007));
+
+        REQUIRE(ModInt<>::pow(ModInt<>(2, 3), 0).value() == 1);
+        REQUIRE(ModInt<>::pow(ModInt<>(1024, 100), 1024).value() == 76);
+        Int p = "170141183460469231731687303715884105727"; // 2^127-1
+        REQUIRE(ModInt<>::pow(ModInt<>(3, p), p - 1).value() == 1);
+        REQUIRE(ModInt<>::pow(ModInt<>(3, p), -1).value() * 3 % p == 1);
+
+        REQUIRE_THROWS_MATCHES(ModInt<10>::pow(2, -1), std::runtime_error, Message("Error: Base is not invertible for the given modulus."));
+    }
+
+    SECTION("print")
+    {
+        std::ostringstream oss;
+        oss << ModInt<7>(10) << ' ' << ModInt<>(-1, "18446744073709551617");
+        REQUIRE(oss.str() == "3 18446744073709551616");
+    }
+
+    SECTION("hash")
+    {
+        REQUIRE(std::hash<ModInt<7>>{}(3) == std::hash<ModInt<7>>{}(10));
+        REQUIRE(std::hash<ModInt<>>{}(ModInt<>(3, "18446744073709551617")) == std::hash<ModInt<>>{}(ModInt<>("18446744073709551620", "18446744073709551617")));
+    }
+}
@@ -0,0 +1,162 @@
+#include "../sources/rope.hpp"
+
+#include "tool.hpp"
+
+using namespace pyincpp;
+
+TEST_CASE("Rope")
+{
+    SECTION("basics")
+    {
+        // Rope()
+        Rope rope1;
+        REQUIRE(rope1.size() == 0);
+        REQUIRE(rope1.is_empty());
+
+        // Rope(const char* chars)
+        Rope rope2("hello");
+        REQUIRE(rope2.size() == 5);
+        REQUIRE(!rope2.is_empty());
+
+        // Rope(const Str& string)
+        Rope rope3(Str("hello"));
+        REQUIRE(rope3.size() == 5);
+        REQUIRE(rope3 == rope2);
+
+        // Rope(const Rope& that)
+        Rope rope4(rope3);
+        REQUIRE(rope4 == rope3);
+
+        // Rope(Rope&& that)
+        Rope rope5(std::move(rope4));
+        REQUIRE(rope5 == rope3);
+        REQUIRE(rope4.is_empty());
+
+        // ~Rope()
+    }
+
+    Str text = Str("0123456789abcdefghijklmnopqrstuvwxyz") * 100; // several chunks
+    Rope empty;
+    Rope some("12345");
+    Rope large(text);
+
+    SECTION("compare")
+    {
+        REQUIRE(some == Rope("12345"));
+        REQUIRE(some != Rope("1234"));
+        REQUIRE(some != Rope("12346"));
+        REQUIRE(large == Rope(text));
+        REQUIRE(empty == Rope(""));
+    }
+
+    SECTION("iterator")
+    {
+        REQUIRE(empty.begin() == empty.end());
+        REQUIRE(std::string(some.begin(), some.end()) == "12345");
+        REQUIRE(std::string(large.begin(), large.end()) == std::string(text.begin(), text.end()));
+    }
+
+    SECTION("access")
+    {
+        REQUIRE(some[0] == '1');
+        REQUIRE(some[-1] == '5');
+        REQUIRE(large[1000] == text[1000]);
+        REQUIRE(large[-1] == 'z');
+        REQUIRE_THROWS_MATCHES(some[5], std::runtime_error, Message("Error: Index out of range."));
+        REQUIRE_THROWS_MATCHES(empty[0], std::runtime_error, Message("Error: Index out of range."));
+    }
+
+    SECTION("find")
+    {
+        REQUIRE(some.find("") == 0);
+        REQUIRE(some.find("345") == 2);
+        REQUIRE(some.find("346") == -1);
+        REQUIRE(some.find("1", 1) == -1);
+        REQUIRE(empty.find("") == 0);
+        REQUIRE(empty.find("1") == -1);
+
+        REQUIRE(large.find("z0") == 35);
+        REQUIRE(large.find("z0", 36) == 71);
+        REQUIRE(large.find(text.slice(500, 600)) == 500 - 36 * 13); // across chunks
+        REQUIRE(large.find("zz") == -1);
+        REQUIRE(large.contains("xyz"));
+        REQUIRE(!large.contains("zyx"));
+    }
+
+    SECTION("concat")
+    {
+        REQUIRE((some + "67") == Rope("1234567"));
+        REQUIRE((empty + some) == some);
+        REQUIRE((some + empty) == some);
+        REQUIRE((large + large).to_str() == text * 2);
+
+        Rope rope;
+        std::string expected;
+        for (int i = 0; i < 10000; ++i)
+        {
+            rope += Str(std::to_string(i));
+            expected += std::to_string(i);
+        }
+        REQUIRE(rope.to_str() == Str(expected));
+        REQUIRE(rope[-1] == '9');
+    }
+
+    SECTION("split_insert_erase_slice")
+    {
+        auto [l, r] = large.split_at(1000);
+        REQUIRE(l.to_str() == text.slice(0, 1000));
+        REQUIRE(r.to_str() == text.slice(1000, text.size()));
+        REQUIRE(l + r == large);
+        REQUIRE(some.split_at(0).first.is_empty());
+        REQUIRE(some.split_at(5).second.is_empty());
+        REQUIRE_THROWS_MATCHES(some.split_at(6), std::runtime_error, Message("Error: Index out of range."));
+
+        REQUIRE(some.insert(0, "0") == Rope("012345"));
+        REQUIRE(some.insert(5, "6") == Rope("123456"));
+        REQUIRE(some.insert(2, "--") == Rope("12--345"));
+        REQUIRE(large.insert(1000, some).to_str() == text.slice(0, 1000) + "12345" + text.slice(1000, text.size()));
+        REQUIRE(some == Rope("12345")); // immutable
+
+        REQUIRE(some.erase(1, 3) == Rope("145"));
+        REQUIRE(some.erase(0, 5).is_empty());
+        REQUIRE(some.erase(3, 3) == some);
+        REQUIRE(large.erase(100, 3000).to_str() == text.erase(100, 3000));
+
+        REQUIRE(some.slice(1, 4) == Rope("234"));
+        REQUIRE(some.slice(-3, -1) == Rope("34"));
+        REQUIRE(some.slice(4, 1).is_empty());
+        REQUIRE(large.slice(700, 2100).to_str() == text.slice(700, 2100));
+    }
+
+    SECTION("random")
+    {
+        Rope rope;
+        std::string expected;
+        std::mt19937 gen(42);
+        for (int i = 0; i < 2000; ++i)
+        {
+            int pos = std::uniform_int_distribution<int>(0, expected.size())(gen);
+            if (gen() % 3 != 0 || expected.empty())
+            {
+                std::string piece(gen() % 50 + 1, char('a' + i % 26));
+                rope = rope.insert(pos, Str(piece));
+                expected.insert(pos, piece);
+            }
+            else
+            {
+                int stop = std::uniform_int_distribution<int>(pos, std::min<int>(expected.size(), pos + 100))(gen);
+                rope = rope.erase(pos, stop);
+                expected.erase(pos, stop - pos);
+            }
+        }
+        REQUIRE(rope.size() == int(expected.size()));
+        REQUIRE(rope.to_str() == Str(expected));
+    }
+
+    SECTION("print")
+    {
+        std::ostringstream oss;
+        oss << some;
+        REQUIRE(oss.str() == "\"12345\"");
+    }
+}
@@ -238,6 +238,57 @@ TEST_CASE("Str")
         REQUIRE_THROWS_MATCHES(Str("1 1").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
         REQUIRE_THROWS_MATCHES(Str("123a").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
         REQUIRE_THROWS_MATCHES(Str("hello").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+        REQUIRE_THROWS_MATCHES(Str("+-1").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+        REQUIRE_THROWS_MATCHES(Str("1e").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+        REQUIRE_THROWS_MATCHES(Str("0x10").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+        REQUIRE_THROWS_MATCHES(Str("nan(1)").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+        REQUIRE_THROWS_MATCHES(Str(" inf").to_decimal(), std::runtime_error, Message("Error: Invalid literal for to_decimal()."));
+
+        // blanks, infinity and nan
+        REQUIRE(Str(" \t12.5\r\n").to_decimal() == 12.5);
+        REQUIRE(Str("-Infinity").to_decimal() == -INFINITY);
+        REQUIRE(std::isnan(Str("-NaN").to_decimal()));
+
+        // correctly rounded
+        REQUIRE(Str("0.1").to_decimal() == 0.1);
+        REQUIRE(Str("2.2250738585072014e-308").to_decimal() == 2.2250738585072014e-308);
+        REQUIRE(Str("1.7976931348623157e308").to_decimal() == 1.7976931348623157e308);
+        REQUIRE(Str("4.9e-324").to_decimal() == 4.9e-324);
+        REQUIRE(Str("9007199254740993").to_decimal() == 9007199254740992.0); // ties to even
+        REQUIRE(Str("123456789012345678901234567890").to_decimal() == 123456789012345678901234567890.0);
+        for (double x : {3.141592653589793, 1e23, 5e-324, 0.3, 2.0 / 3, 1e300 / 7})
+        {
+            char chars[32];
+            auto [ptr, ec] = std::to_chars(chars, chars + sizeof(chars), x);
+            REQUIRE(StrView(std::string_view(chars, ptr - chars)).to_decimal() == x);
+        }
+
+        // out of range
+        REQUIRE(Str("-1e600").to_decimal() == -HUGE_VAL);
+        REQUIRE(Str("0.00001e309").to_decimal() == 1e304);
+        REQUIRE(Str("1e-600").to_decimal() == 0);
+        REQUIRE(Str("1e99999999999999999999").to_decimal() == HUGE_VAL);
+        REQUIRE(Str("1e-99999999999999999999").to_decimal() == 0);
+    }
+
+    SECTION("to_decimals")
+    {
+        REQUIRE(Str("1.5\n-2\n3e2\n").to_decimals() == List<double>{1.5, -2, 300});
+        REQUIRE(StrView("  1 \t 2\r\n\n3 ").to_decimals() == List<double>{1, 2, 3});
+        REQUIRE(StrView("1.5, -2 ,3e2").to_decimals(',') == List<double>{1.5, -2, 300});
+        REQUIRE(StrView("0.1|inf").to_decimals('|') == List<double>{0.1, INFINITY});
+        REQUIRE(StrView("").to_decimals().is_empty());
+        REQUIRE(StrView(" \n ").to_decimals().is_empty());
+        REQUIRE(StrView("").to_decimals(',').is_empty());
+        REQUIRE(StrView("1\n 2").to_decimals('\n') == List<double>{1, 2});
+        REQUIRE(StrView("-inf nan 1e999").to_decimals().size() == 3);
+
+        REQUIRE_THROWS_MATCHES(StrView("1 2 x").to_decimals(), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
+        REQUIRE_THROWS_MATCHES(StrView("1,,2").to_decimals(','), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
+        REQUIRE_THROWS_MATCHES(StrView("1,2,").to_decimals(','), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
+        REQUIRE_THROWS_MATCHES(StrView("1\n\n2").to_decimals('\n'), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
+        REQUIRE_THROWS_MATCHES(StrView("1 2").to_decimals(','), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
+        REQUIRE_THROWS_MATCHES(StrView("1x 2").to_decimals(), std::runtime_error, Message("Error: Invalid literal for to_decimals()."));
     }
 
     SECTION("to_integer")
@@ -274,6 +325,31 @@ TEST_CASE("Str")
         // error
         REQUIRE_THROWS_MATCHES(Str("123").to_integer(99), std::runtime_error, Message("Error: Invalid base for to_integer()."));
         REQUIRE_THROWS_MATCHES(Str("!!!").to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str("").to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str(" - ").to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str("+-1").to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str("1 2").to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str("12").to_integer(2), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+        REQUIRE_THROWS_MATCHES(Str("0123456789abcdef0123456789abcdefg").to_integer(16), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+
+        // long digit runs in all bases, round trip with Int::to_string
+        for (int base = 2; base <= 36; ++base)
+        {
+            for (int digits : {1, 15, 16, 17, 31, 32, 33, 64, 100})
+            {
+                Int integer = Int::random(digits) * (digits % 2 ? -1 : 1);
+                std::string text = integer.to_string(base);
+                REQUIRE(Str(text).to_integer(base) == integer);
+                std::transform(text.begin(), text.end(), text.begin(), [](char ch)
+                               { return std::toupper(ch); });
+                REQUIRE(Str(" " + text + "\n").to_integer(base) == integer);
+            }
+        }
+        REQUIRE(Str("0000000000000000000000000000000000000000000000000000000000000001").to_integer(16) == 1);
+        REQUIRE(Str("00000000000000000000000000000000000000000000000000000000000000000").to_integer(8) == 0);
+        REQUIRE(Str("7" + std::string(100, '7')).to_integer(8) == Int::pow(8, 101) - 1);
+        REQUIRE(Str(std::string(64, 'f')).to_integer(16) == Int::pow(2, 256) - 1);
+        REQUIRE(Str(std::string(64, 'v')).to_integer(32) == Int::pow(2, 320) - 1);
     }
 
     SECTION("reverse")
@@ -290,6 +366,33 @@ TEST_CASE("Str")
 
         REQUIRE(Str("hahaha").upper() == "HAHAHA");
         REQUIRE(Str("some@earth.com").upper() == "SOME@EARTH.COM");
+
+        REQUIRE(Str("Hello World").swapcase() == "hELLO wORLD");
+        REQUIRE(empty.swapcase() == empty);
+
+        // every byte, long enough for the SIMD kernels, compared with the C library
+        std::string bytes;
+        for (int c = 0; c < 256; ++c)
+        {
+            bytes += char(c);
+        }
+        std::string lower = bytes, upper = bytes, swapped = bytes;
+        for (auto& c : lower)
+        {
+            c = std::tolower(static_cast<unsigned char>(c));
+        }
+        for (auto& c : upper)
+        {
+            c = std::toupper(static_cast<unsigned char>(c));
+        }
+        for (auto& c : swapped)
+        {
+            c = std::isupper(static_cast<unsigned char>(c)) ? std::tolower(c) : std::toupper(static_cast<unsigned char>(c));
+        }
+        REQUIRE(Str(bytes).lower() == lower);
+        REQUIRE(Str(bytes).upper() == upper);
+        REQUIRE(Str(bytes).swapcase() == swapped);
+        REQUIRE(Str(bytes).slice(3, 200).upper() == upper.substr(3, 197));
     }
 
     SECTION("erase")
@@ -322,6 +425,63 @@ TEST_CASE("Str")
         REQUIRE(Str("           hello           ").strip() == "hello");
         REQUIRE(Str("\n\n\n\n \t\n\b\n   hello  \n\n\t\n \r\b\n\r").strip() == "hello");
         REQUIRE(Str("'''hello'''").strip('\'') == "hello");
+
+        REQUIRE(Str("  hello  ").lstrip() == "hello  ");
+        REQUIRE(Str("  hello  ").rstrip() == "  hello");
+        REQUIRE(Str("**hello**").lstrip('*') == "hello**");
+        REQUIRE(Str("**hello**").rstrip('*') == "**hello");
+        REQUIRE(Str("   ").strip().is_empty());
+        REQUIRE(Str("   ").lstrip().is_empty());
+        REQUIRE(Str("   ").rstrip().is_empty());
+        REQUIRE(empty.strip().is_empty());
+        REQUIRE(Str("\xe4\xbd\xa0\xe5\xa5\xbd").strip() == "\xe4\xbd\xa0\xe5\xa5\xbd"); // non-ASCII bytes are not blank
+
+        // long runs for the SIMD kernels
+        Str padded = Str(" \t\n") * 30 + "x y" + Str("\r\n ") * 30;
+        REQUIRE(padded.strip() == "x y");
+        REQUIRE(padded.lstrip() == Str("x y") + Str("\r\n ") * 30);
+        REQUIRE(padded.rstrip() == Str(" \t\n") * 30 + "x y");
+        REQUIRE((Str("-") * 100 + "x" + Str("-") * 40).strip('-') == "x");
+        REQUIRE((Str("-") * 100).strip('-').is_empty());
+    }
+
+    SECTION("is_class")
+    {
+        REQUIRE(Str("0123456789").is_digit());
+        REQUIRE(!Str("123a").is_digit());
+        REQUIRE(!empty.is_digit());
+        REQUIRE(Str("HelloWorld").is_alpha());
+        REQUIRE(!Str("Hello World").is_alpha());
+        REQUIRE(!Str("[`@{").is_alpha());
+        REQUIRE(!empty.is_alpha());
+        REQUIRE(Str("abc123XYZ").is_alnum());
+        REQUIRE(!Str("abc_123").is_alnum());
+        REQUIRE(!empty.is_alnum());
+        REQUIRE(Str(" \t\n\v\f\r").is_space());
+        REQUIRE(!Str(" \b ").is_space());
+        REQUIRE(!empty.is_space());
+        REQUIRE(Str("hello\x7f").is_ascii());
+        REQUIRE(!Str("caf\xc3\xa9").is_ascii());
+        REQUIRE(empty.is_ascii());
+
+        // long strings for the SIMD kernels, with the odd one out at each position
+        Str digits = Str("0123456789") * 7;
+        REQUIRE(digits.is_digit());
+        REQUIRE(digits.is_alnum());
+        REQUIRE(digits.is_ascii());
+        for (int i = 0; i < digits.size(); ++i)
+        {
+            std::string other(digits.begin(), digits.end());
+            other[i] = 'x';
+            REQUIRE(!Str(other).is_digit());
+            REQUIRE(Str(other).is_alnum());
+            other[i] = '\x80';
+            REQUIRE(!Str(other).is_ascii());
+        }
+        REQUIRE((Str("aZ") * 40).is_alpha());
+        REQUIRE(!(Str("aZ") * 40 + "5").is_alpha());
+        REQUIRE((Str(" \t\r\n") * 20).is_space());
+        REQUIRE(!(Str(" \t\r\n") * 20 + "\x1c").is_space());
     }
 
     SECTION("rotate")
@@ -407,6 +567,261 @@ TEST_CASE("Str")
         REQUIRE(Str(" ").split(" ", true) == List<Str>{"", ""});
     }
 
+    SECTION("search")
+    {
+        // compare with std::string_view::find on random texts of a small alphabet, so there are many partial matches
+        std::mt19937 gen(42);
+        auto random_text = [&](int len, char max)
+        {
+            std::string text(len, 'a');
+            for (auto& ch : text)
+            {
+                ch = 'a' + gen() % (max - 'a' + 1);
+            }
+            return text;
+        };
+        for (int round = 0; round < 300; ++round)
+        {
+            std::string hay = random_text(gen() % 300, round % 2 ? 'b' : 'd');
+            std::string needle = random_text(gen() % 8 + 1, round % 2 ? 'b' : 'd');
+            int start = gen() % (hay.size() + 1);
+
+            auto expected = std::string_view(hay).find(needle, start);
+            REQUIRE(Str(hay).find(needle.c_str(), start) == (expected == std::string::npos ? -1 : int(expected)));
+            REQUIRE(Str(hay).find(Str::Pattern(needle.c_str()), start) == (expected == std::string::npos ? -1 : int(expected)));
+
+            int cnt = 0;
+            for (auto pos = hay.find(needle); pos != std::string::npos; pos = hay.find(needle, pos + needle.size()))
+            {
+                ++cnt;
+            }
+            REQUIRE(Str(hay).count(needle.c_str()) == cnt);
+        }
+
+        // long texts of two characters make many false positives, so the search switches to Two-Way
+        for (int round = 0; round < 50; ++round)
+        {
+            std::string hay = random_text(5000, 'b');
+            std::string needle = random_text(gen() % 40 + 2, 'b');
+            int start = gen() % 100;
+
+            auto expected = std::string_view(hay).find(needle, start);
+            REQUIRE(StrView(hay).find(needle.c_str(), start) == (expected == std::string::npos ? -1 : int(expected)));
+            needle = hay.substr(4000 + gen() % 900, needle.size()); // must be found
+            REQUIRE(StrView(hay).find(needle.c_str(), start) == int(std::string_view(hay).find(needle, start)));
+        }
+
+        // worst case of the filter
+        std::string hay(100000, 'a');
+        std::string needle = std::string(1000, 'a') + "b";
+        REQUIRE(StrView(hay).find(needle.c_str()) == -1);
+        REQUIRE(StrView(hay + "b").find(needle.c_str()) == 99000);
+        REQUIRE(StrView(hay + "b").count(StrView(needle)) == 1);
+        std::string periodic = std::string(500, 'a') + "ba" + std::string(500, 'a');
+        REQUIRE(StrView(hay + periodic).find(periodic.c_str()) == 100000);
+
+        // precompiled pattern
+        Str::Pattern pattern("needle");
+        REQUIRE(pattern.size() == 6);
+        REQUIRE(Str("haystack with a needle, and another needle").find(pattern) == 16);
+        REQUIRE(Str("haystack with a needle, and another needle").find(pattern, 17) == 36);
+        REQUIRE(Str("haystack with a needle, and another needle").find(pattern, 0, 21) == -1);
+        REQUIRE(Str("haystack with a needle, and another needle").count(pattern) == 2);
+        REQUIRE(StrView("no match").contains(pattern) == false);
+        REQUIRE(Str("needle").contains(pattern));
+
+        // single character
+        REQUIRE(Str(std::string(1000, 'x') + "y").find("y") == 1000);
+        REQUIRE(StrView(Str("abcabc") * 100).count("c") == 200);
+        REQUIRE(StrView("").count("c") == 0);
+    }
+
+    SECTION("multi_pattern")
+    {
+        Str::PatternSet keywords({"he", "she", "his", "hers"});
+        REQUIRE(keywords.size() == 4);
+        REQUIRE(Str("ushers").find_any(keywords) == std::pair{1, 1});
+        REQUIRE(Str("ushers").find_any(keywords, 2) == std::pair{2, 3});
+        REQUIRE(Str("ushers").find_any(keywords, 3) == std::pair{-1, -1});
+        REQUIRE(Str("ushers").find_any(keywords, 100) == std::pair{-1, -1});
+        REQUIRE(Str("ushers").count_many(keywords) == List<int>{1, 1, 0, 1});
+        REQUIRE(StrView("abcd").find_any({"bcd", "ab", "abc"}) == std::pair{0, 2});
+        REQUIRE(StrView("aaaa").count_many({"a", "aa", "b", "aa"}) == List<int>{4, 2, 0, 2});
+
+        // leftmost, then longest
+        Str::PatternSet words({"cat", "category", "dog"});
+        REQUIRE(Str("dog category").replace_many(words, {"animal", "class", "pet"}) == "pet class");
+        REQUIRE(Str("abcd").replace_many({{"bc", "X"}, {"abcd", "Y"}}) == "Y");
+        REQUIRE(Str("abce").replace_many({{"bc", "X"}, {"abcd", "Y"}}) == "aXe");
+        REQUIRE(Str("hahaha").replace_many({{"a", "o"}, {"h", "H"}}) == "HoHoHo");
+        REQUIRE(Str("hello world").replace_many({{"hello", "bye"}, {"world", "moon"}}) == "bye moon");
+        REQUIRE(Str("abc").replace_many({}) == "abc");
+        REQUIRE(Str("").replace_many({{"a", "b"}}) == "");
+
+        REQUIRE_THROWS_MATCHES(Str::PatternSet({"a", ""}), std::runtime_error, Message("Error: Empty pattern."));
+        REQUIRE_THROWS_MATCHES(Str("abc").replace_many(words, {"x"}), std::runtime_error, Message("Error: Require the same number of patterns and replacements for replace_many."));
+
+        // compare with the single pattern methods on random texts of a small alphabet
+        std::mt19937 gen(233);
+        auto random_text = [&](int len)
+        {
+            std::string text(len, 'a');
+            for (auto& ch : text)
+            {
+                ch = 'a' + gen() % 3;
+            }
+            return text;
+        };
+        for (int round = 0; round < 200; ++round)
+        {
+            List<Str> patterns;
+            for (int i = gen() % 6 + 1; i > 0; --i)
+            {
+                patterns += random_text(gen() % 4 + 1);
+            }
+            Str::PatternSet set(patterns);
+            Str text = random_text(gen() % 100);
+
+            List<int> counts = text.count_many(set);
+            for (int i = 0; i < patterns.size(); ++i)
+            {
+                REQUIRE(counts[i] == text.count(patterns[i]));
+            }
+
+            // naive leftmost-longest
+            int best_start = -1, best = -1;
+            for (int i = 0; i < patterns.size(); ++i)
+            {
+                int pos = text.find(patterns[i]);
+                if (pos != -1 && (best == -1 || pos < best_start || (pos == best_start && patterns[i].size() > patterns[best].size())))
+                {
+                    best_start = pos;
+                    best = i;
+                }
+            }
+            auto [pos, p] = text.find_any(set);
+            REQUIRE(pos == best_start);
+            REQUIRE((p == -1 ? Str() : patterns[p]) == (best == -1 ? Str() : patterns[best]));
+        }
+
+        // the automaton is reused across inputs
+        Str::PatternSet secrets(List<Str>{"password", "token", "key"});
+        List<Str> redacted = {"***", "***", "***"};
+        REQUIRE(Str("password=1, token=2").replace_many(secrets, redacted) == "***=1, ***=2");
+        REQUIRE(Str("monkey").replace_many(secrets, redacted) == "mon***");
+        REQUIRE(Str("nothing").replace_many(secrets, redacted) == "nothing");
+    }
+
+    SECTION("str_view")
+    {
+        std::string text = "  -0x1f, 233.33e-2, hello world  ";
+        StrView view(text);
+        REQUIRE(view.size() == int(text.size()));
+        REQUIRE(view.data() == text.data());
+        REQUIRE(view[2] == '-');
+        REQUIRE(view[-1] == ' ');
+
+        StrView stripped = view.strip();
+        REQUIRE(stripped == "-0x1f, 233.33e-2, hello world");
+        REQUIRE(stripped.data() == text.data() + 2); // no copy
+        REQUIRE(StrView("**a**").strip('*') == "a");
+        REQUIRE(StrView("   ").strip().is_empty());
+        REQUIRE(view.lstrip().data() == text.data() + 2);
+        REQUIRE(view.rstrip().data() == text.data());
+        REQUIRE(view.rstrip().size() == int(text.size()) - 2);
+        REQUIRE(StrView("233").is_digit());
+        REQUIRE(!stripped.is_alnum());
+        REQUIRE(stripped.is_ascii());
+
+        REQUIRE(stripped.find("hello") == 18);
+        REQUIRE(stripped.find("hello", 0, 20) == -1);
+        REQUIRE(stripped.contains(Str("world")));
+        REQUIRE(stripped.count("l") == 3);
+        REQUIRE(stripped.starts_with("-0x"));
+        REQUIRE(stripped.ends_with("world"));
+
+        REQUIRE(stripped.slice(3, 5).to_integer(16) == 31);
+        REQUIRE(stripped.slice(0, 5).slice(1, -1) == "0x1");
+        REQUIRE(stripped.slice(7, 16).to_decimal() == Approx(2.3333));
+        REQUIRE(StrView("-Infinity").to_decimal() == -INFINITY);
+        REQUIRE(std::isnan(StrView("NaN").to_decimal()));
+        REQUIRE_THROWS_MATCHES(stripped.to_integer(), std::runtime_error, Message("Error: Invalid literal for to_integer()."));
+
+        // Str <-> StrView
+        Str str("hello");
+        StrView str_view = str;
+        REQUIRE(str_view.data() == str.data());
+        REQUIRE(Str(str_view.slice(1, 3)) == "el");
+        REQUIRE(std::hash<StrView>{}(str_view) == std::hash<Str>{}(str));
+
+        std::ostringstream oss;
+        oss << str_view;
+        REQUIRE(oss.str() == "\"hello\"");
+    }
+
+    SECTION("split_view")
+    {
+        auto collect = [](const auto& range)
+        {
+            std::vector<std::string> pieces;
+            for (StrView piece : range)
+            {
+                pieces.emplace_back(piece.view());
+            }
+            return pieces;
+        };
+        using V = std::vector<std::string>;
+
+        static_assert(std::ranges::forward_range<StrView::SplitRange>);
+
+        REQUIRE(collect(StrView("one, two, three").split_view(", ")) == V{"one", "two", "three"});
+        REQUIRE(collect(StrView("   1   2   3   ").split_view()) == V{"1", "2", "3"});
+        REQUIRE(collect(StrView("aaa").split_view("a")).empty());
+        REQUIRE(collect(StrView("aaa").split_view("a", true)) == V{"", "", "", ""});
+        REQUIRE(collect(StrView("").split_view()).empty());
+        REQUIRE(collect(StrView("").split_view(" ", true)) == V{""});
+        REQUIRE_THROWS_MATCHES(StrView("a").split_view(""), std::runtime_error, Message("Error: Empty separator."));
+
+        REQUIRE(collect(StrView("a\r\n\nb\rc\n").splitlines_view()) == V{"a", "", "b", "c"});
+        REQUIRE(collect(StrView("\n").splitlines_view()) == V{""});
+        REQUIRE(collect(StrView("").splitlines_view()).empty());
+        REQUIRE(collect(StrView("no newline").splitlines_view()) == V{"no newline"});
+
+        // same pieces as split(), pointing into the string
+        Str str("192.168.0.1");
+        REQUIRE(collect(str.split_view(".")) == V{"192", "168", "0", "1"});
+        REQUIRE((*str.split_view(".").begin()).data() == str.data());
+        REQUIRE(collect(Str("x\ny").splitlines_view()) == V{"x", "y"});
+        REQUIRE(Str(", ").join(str.split_view(".")) == "192, 168, 0, 1");
+    }
+
+    SECTION("str_builder")
+    {
+        StrBuilder builder;
+        REQUIRE(builder.is_empty());
+        REQUIRE(builder.to_str() == "");
+
+        builder.append(Str("x = ")).append(1).append(", ").append('y').append(std::string_view(" = ")).append(2.5);
+        REQUIRE(builder.size() == 14);
+        REQUIRE(builder.to_str() == "x = 1, y = 2.5");
+
+        builder.clear().append(Int("-18446744073709551617")).append(' ').append(LLONG_MIN).append(' ').append(0u);
+        REQUIRE(builder.to_str() == "-18446744073709551617 -9223372036854775808 0");
+
+        builder.clear().append(true).append(false).append(' ').append_format("{}", true);
+        REQUIRE(builder.to_str() == "10 1");
+
+        builder.clear().append_format("{} + {} = {}", 1, 2, 3).append_format("!");
+        REQUIRE(builder.to_str() == "1 + 2 = 3!");
+
+        StrBuilder reserved(100);
+        REQUIRE(reserved.capacity() >= 100);
+        reserved.reserve(1000).append("hello");
+        REQUIRE(reserved.capacity() >= 1000);
+        REQUIRE(std::move(reserved).to_str() == "hello");
+        REQUIRE_THROWS_MATCHES(reserved.reserve(-1), std::runtime_error, Message("Error: Require capacity >= 0 for reserve(capacity)."));
+    }
+
     SECTION("join")
     {
         REQUIRE(Str(", ").join({}) == "");
@@ -415,6 +830,13 @@ TEST_CASE("Str")
         REQUIRE(Str(", ").join({"a", "b", "c"}) == "a, b, c");
         REQUIRE(Str("").join({"a", "b", "c"}) == "abc");
         REQUIRE(Str(".").join({"192", "168", "0", "1"}) == "192.168.0.1");
+
+        // any range of string-like objects
+        REQUIRE(Str(", ").join(std::vector<Str>{}) == "");
+        REQUIRE(Str(", ").join(std::vector<std::string_view>{"a", "b"}) == "a, b");
+        REQUIRE(Str("-").join(std::vector<std::string>{"a", "b", "c"}) == "a-b-c");
+        REQUIRE(Str("").join(std::vector<const char*>{"a", "b"}) == "ab");
+        REQUIRE(Str(" ").join(Str("1 2 3").split()) == "1 2 3");
     }
 
     SECTION("format")
@@ -422,6 +844,296 @@ TEST_CASE("Str")
         REQUIRE(Str("{}, {}, {}, {}.").format(1, 2, 3, 4) == "1, 2, 3, 4.");
         REQUIRE(Str("I'm {}, {} years old.").format("Alice", 18) == "I'm Alice, 18 years old.");
         REQUIRE(Str("{} -> {}").format(List<int>{1, 2, 3}, List<Str>{"one", "two", "three"}) == "[1, 2, 3] -> [\"one\", \"two\", \"three\"]");
+        REQUIRE(Str("{} {} {} {}").format(3.14159265, 'c', Str("s"), Int("-123456789012345678901234567890")) == "3.14159 c \"s\" -123456789012345678901234567890");
+        REQUIRE(Str("{{}} {{{}}}").format(1) == "{} {1}");
+        REQUIRE(Str("{}").format(1, 2) == "1");
+        REQUIRE(Str("no fields").format() == "no fields");
+
+        // format spec
+        REQUIRE(Str("{:5}|{:<5}|{:^5}|{:>5}|{:*^6}").format(42, 42, 42, "ab", "ab") == "   42|42   | 42  |   ab|**ab**");
+        REQUIRE(Str("{:+}|{: }|{:-}|{:+}").format(1, 1, 1, -1) == "+1| 1|1|-1");
+        REQUIRE(Str("{:b}|{:o}|{:x}|{:X}|{:#b}|{:#o}|{:#x}|{:#X}").format(10, 10, 255, 255, 10, 10, 255, 255) == "1010|12|ff|FF|0b1010|0o12|0xff|0XFF");
+        REQUIRE(Str("{:08x}|{:#010x}|{:05}|{:=+6}|{:<05}").format(255, 255, -42, 42, 1) == "000000ff|0x000000ff|-0042|+   42|10000");
+        REQUIRE(Str("{:x}|{:d}").format(LLONG_MIN, ULLONG_MAX) == "-8000000000000000|18446744073709551615");
+        REQUIRE(Str("{:.3f}|{:8.2f}|{:08.2f}|{:.2e}|{:E}|{:g}|{:.3}|{:.1%}").format(3.14159, 3.14159, -3.14159, 12345.678, 0.5, 1e-10, 3.14159, 0.256) == "3.142|    3.14|-0003.14|1.23e+04|5.000000E-01|1e-10|3.14|25.6%");
+        REQUIRE(Str("{:f}|{:F}|{:+.1f}").format(INFINITY, -INFINITY, 2.25) == "inf|-INF|+2.2");
+        REQUIRE(Str("{:.2f}|{:.0%}").format(7, 1) == "7.00|100%");
+        REQUIRE(Str("{:f}").format(1e1000L).size() == 1007); // 1000 digits before the point, longer than the stack buffer
+        REQUIRE(Str("{:f}").format(1e1000L).ends_with(".000000"));
+        REQUIRE(Str("{:.0%}").format(1e1000L).size() == 1003);
+        REQUIRE(Str("{:.0%}").format(1e1000L).ends_with("%"));
+        REQUIRE(Str("{:.2}|{:>4s}|{:c}|{:d}|{:x}").format("abc", std::string("ab"), 'a', 'a', 'a') == "ab|  ab|a|97|61");
+        REQUIRE(Str("{:x}|{:#b}|{:>+8}").format(Int(255), Int(-5), Int(42)) == "ff|-0b101|     +42");
+        REQUIRE(Str("{:>12}|{:<8}|").format(List<int>{1, 2}, Str("s")) == "      [1, 2]|\"s\"     |");
+
+        // indexed and named fields
+        REQUIRE(Str("{0}").format(1) == "1");
+        REQUIRE(Str("{name}").format(1) == "1");
+        REQUIRE(Str("{1}{0}{1}").format("a", "b") == "bab");
+        REQUIRE(Str("{1:08x}|{0:>3}|{name:.1f}").format(1, 255) == "000000ff|  1|1.0");
+
+        // unfilled fields and unmatched braces are left unchanged
+        REQUIRE(Str("{} {}").format(1) == "1 {}");
+        REQUIRE(Str("{}").format() == "{}");
+        REQUIRE(Str("{2} {}").format(1) == "{2} 1");
+        REQUIRE(Str("{").format(1) == "{");
+        REQUIRE(Str("}").format() == "}");
+        REQUIRE(Str("a } b").format() == "a } b");
+        REQUIRE(Str("a } b {}").format(1) == "a } b 1");
+        REQUIRE(Str("{} }}").format(1) == "1 }");
+
+        REQUIRE_THROWS_MATCHES(Str("{:q}").format(1), std::runtime_error, Message("Error: Invalid format string."));
+        REQUIRE_THROWS_MATCHES(Str("{:>5}}").format(1), std::runtime_error, Message("Error: Invalid format string."));
+        REQUIRE_THROWS_MATCHES(Str("{0:d}").format(1.5), std::runtime_error, Message("Error: Invalid format spec for the argument."));
+        REQUIRE_THROWS_MATCHES(Str("{:d}").format(1.5), std::runtime_error, Message("Error: Invalid format spec for the argument."));
+        REQUIRE_THROWS_MATCHES(Str("{:+}").format("s"), std::runtime_error, Message("Error: Invalid format spec for the argument."));
+        REQUIRE_THROWS_MATCHES(Str("{:.2}").format(1), std::runtime_error, Message("Error: Invalid format spec for the argument."));
+        REQUIRE_THROWS_MATCHES(Str("{:x}").format(List<int>{}), std::runtime_error, Message("Error: Invalid format spec for the argument."));
+
+        // checked at compile time
+        REQUIRE(StrBuilder().append_format("{:>8.3f}|{:#06x}|{{{}}}", 3.14159, 255, "x").to_str() == "   3.142|0x00ff|{x}");
+        REQUIRE(StrBuilder().append_format("{} + {} = {:.1f}", 1, 2, 3.0).to_str() == "1 + 2 = 3.0");
+        REQUIRE(StrBuilder().append_format("{}", Int(-7)).append_format(" {:>3}", List<int>{}).to_str() == "-7  []");
+        REQUIRE(StrBuilder().append_format("{1}-{0:>3}-{1:#x}|{}", 7, 255).to_str() == "255-  7-0xff|7");
+        REQUIRE(StrBuilder().append_format("{x} and {y}", 1, 2).to_str() == "1 and 2");
+        REQUIRE(StrBuilder().append_format("a } b {{", 1).to_str() == "a } b {");
+    }
+
+    SECTION("hash_intern")
+    {
+        // cached hash
+        Str key = "some key";
+        std::size_t hash = std::hash<Str>{}(key);
+        REQUIRE(std::hash<Str>{}(key) == hash);
+        REQUIRE(std::hash<Str>{}(Str(key)) == hash);
+        REQUIRE(std::hash<StrView>{}(key) == hash);
+        Str other = "other key";
+        REQUIRE(std::hash<Str>{}(other) != hash);
+        REQUIRE(key != other); // different cached hashes
+        Str copy = key;
+        copy = other; // the cached hash goes with the characters
+        REQUIRE(std::hash<Str>{}(copy) == std::hash<Str>{}(other));
+        REQUIRE(copy == other);
+        std::istringstream("new line") >> copy;
+        REQUIRE(std::hash<Str>{}(copy) == std::hash<std::string_view>{}("new line"));
+
+        // interning
+        Str a = Str("symbol").intern();
+        Str b = (Str("sym") + "bol").intern();
+        REQUIRE(a.is_interned());
+        REQUIRE(!Str("symbol").is_interned());
+        REQUIRE(a == b);
+        REQUIRE(a.data() != b.data()); // equal by identity of the pool entry, not by sharing characters
+        REQUIRE(a == "symbol");
+        REQUIRE(a != Str("symbols").intern());
+        REQUIRE(a < Str("symbols").intern());
+        REQUIRE(a.intern().is_interned());
+        REQUIRE(std::hash<Str>{}(a) == std::hash<Str>{}(Str("symbol")));
+        Str moved = std::move(b);
+        REQUIRE(moved.is_interned());
+        REQUIRE(moved == a);
+        REQUIRE(!b.is_interned());
+
+        std::unordered_set<Str> symbols;
+        for (const char* name : {"x", "y", "x", "z", "y"})
+        {
+            symbols.insert(Str(name).intern());
+        }
+        REQUIRE(symbols.size() == 3);
+        REQUIRE(symbols.contains(Str("z")));
+        Dict<Str, int> table = {{Str("x").intern(), 1}, {Str("y").intern(), 2}};
+        REQUIRE(table[Str("y").intern()] == 2);
+
+        // interned from many threads
+        std::vector<std::thread> threads;
+        std::vector<Str> results(8);
+        for (int i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([&results, i]
+                                 { results[i] = Str("shared").intern(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto& result : results)
+        {
+            REQUIRE(result.is_interned());
+            REQUIRE(result == results[0]);
+        }
+
+        // an entry is removed with the last string interned to it, and interned again later
+        {
+            Str temporary = Str("temporary symbol").intern();
+            Str copy = temporary;
+            REQUIRE(copy.is_interned());
+        }
+        Str again = Str("temporary symbol").intern();
+        REQUIRE(again.is_interned());
+        REQUIRE(again == Str("temporary symbol").intern());
+        REQUIRE(again != a);
+    }
+
+    SECTION("shared_buffer")
+    {
+        Str text = Str("  ") + Str("0123456789") * 10 + "  "; // 104 chars
+
+        // copies, slices, strip and split pieces share the characters
+        Str copy = text;
+        REQUIRE(copy.data() == text.data());
+        Str slice = text.slice(2, 102);
+        REQUIRE(slice.data() == text.data() + 2);
+        REQUIRE(slice == Str("0123456789") * 10);
+        REQUIRE(slice.slice(10, -10).data() == text.data() + 12);
+        REQUIRE(text.strip().data() == text.data() + 2);
+        REQUIRE(text.strip() == slice);
+        Str csv = Str("first piece is long,second piece is longer,x");
+        auto pieces = csv.split(",");
+        REQUIRE(pieces == List<Str>({"first piece is long", "second piece is longer", "x"}));
+        REQUIRE(pieces[0].data() == csv.data());
+        REQUIRE(pieces[1].data() == csv.data() + 20);
+
+        // short strings are stored inline
+        Str small = "small";
+        Str small_copy = small;
+        REQUIRE(small_copy.data() != small.data());
+        REQUIRE(small_copy == "small");
+        REQUIRE(text.slice(2, 7) == "01234");
+        REQUIRE(text.slice(2, 7).data() != text.data() + 2);
+        REQUIRE(text.slice(5, 5).is_empty());
+        REQUIRE(text.slice(2, 102, 10) == "0000000000");
+
+        // a substring keeps the characters alive after the parent is gone
+        Str piece;
+        {
+            Str parent = Str("abc") * 100;
+            piece = parent.slice(3, 60);
+        }
+        REQUIRE(piece == Str("abc") * 19);
+        REQUIRE(std::hash<Str>{}(piece) == std::hash<std::string_view>{}(std::string_view(piece.data(), piece.size())));
+
+        // compact copies only the characters of the substring
+        Str compacted = slice.compact();
+        REQUIRE(compacted == slice);
+        REQUIRE(compacted.data() != slice.data());
+        REQUIRE(compacted.compact().data() == compacted.data());
+        REQUIRE(text.compact().data() == text.data());
+        REQUIRE(small.compact() == "small");
+
+        // moved-from strings are empty
+        Str moved = std::move(copy);
+        REQUIRE(moved.data() == text.data());
+        REQUIRE(copy.is_empty());
+        copy = std::move(small);
+        REQUIRE(copy == "small");
+        REQUIRE(small.is_empty());
+
+        // the inline characters overlap the shared buffer, and the rarely used state is allocated on demand
+        REQUIRE(sizeof(Str) <= 4 * sizeof(void*));
+        Str key = Str("key ") * 10;
+        std::size_t hash = std::hash<Str>{}(key);
+        Str key_copy = key;
+        REQUIRE(std::hash<Str>{}(key_copy) == hash);
+        Str interned = key_copy.intern();
+        REQUIRE(interned.is_interned());
+        REQUIRE(!key.is_interned());
+        REQUIRE(!key_copy.is_interned());
+        REQUIRE(interned == key);
+        REQUIRE(interned.compact().is_interned());
+        Str utf8 = Str("é") * 20;
+        REQUIRE(Str(utf8).utf8_size() == 20);
+        REQUIRE(utf8.utf8_size() == 20);
+        REQUIRE(Str("é").utf8_size() == 1);
+        REQUIRE(Str("e").utf8_size() == 1);
+
+        // c_str is null-terminated, copying only a piece in the middle of the buffer
+        REQUIRE(std::strlen(slice.c_str()) == 100);
+        REQUIRE(slice.c_str() != slice.data());
+        REQUIRE(slice.c_str() == slice.c_str());
+        REQUIRE(Str(slice).c_str() == slice.c_str());
+        REQUIRE(text.slice(2, text.size()).c_str() == text.data() + 2);
+        REQUIRE(text.c_str() == text.data());
+        REQUIRE(std::strcmp(pieces[0].c_str(), "first piece is long") == 0);
+        REQUIRE(std::strcmp(small.c_str(), "") == 0);
+        REQUIRE(std::strcmp(small_copy.c_str(), "small") == 0);
+    }
+
+    SECTION("utf8")
+    {
+        Str text = "héllo, 世界!";
+        REQUIRE(text.size() == 15);
+        REQUIRE(text.utf8_size() == 10);
+        REQUIRE(text.is_utf8());
+        REQUIRE(!text.is_ascii());
+        REQUIRE(StrView(text).utf8_size() == 10);
+
+        // access by code point
+        REQUIRE(text.utf8_at(0) == "h");
+        REQUIRE(text.utf8_at(1) == "é");
+        REQUIRE(text.utf8_at(7) == "世");
+        REQUIRE(text.utf8_at(-1) == "!");
+        REQUIRE(text.utf8_at(-2) == "界");
+        REQUIRE_THROWS_MATCHES(text.utf8_at(10), std::runtime_error, Message("Error: Index out of range."));
+        REQUIRE_THROWS_MATCHES(text.utf8_at(-11), std::runtime_error, Message("Error: Index out of range."));
+
+        // slice by code point
+        REQUIRE(text.utf8_slice(1, 4) == "éll");
+        REQUIRE(text.utf8_slice(7, 10) == "世界!");
+        REQUIRE(text.utf8_slice(-3, -1) == "世界");
+        REQUIRE(text.utf8_slice(0, 10, 3) == "hl !");
+        REQUIRE(text.utf8_slice(-1, -11, -1) == "!界世 ,olléh");
+        REQUIRE(text.utf8_slice(5, 5).is_empty());
+        REQUIRE_THROWS_MATCHES(text.utf8_slice(0, 1, 0), std::runtime_error, Message("Error: Require step != 0 for slice(start, stop, step)."));
+        REQUIRE(text.utf8_reverse() == "!界世 ,olléh");
+        REQUIRE(Str("abc").utf8_reverse() == "cba");
+        REQUIRE(empty.utf8_reverse() == empty);
+        REQUIRE(empty.utf8_size() == 0);
+
+        // long text, the index records every 64th code point
+        Str long_text = Str("añ世😀") * 100;
+        REQUIRE(long_text.utf8_size() == 400);
+        for (int i = 0; i < 400; ++i)
+        {
+            REQUIRE(long_text.utf8_at(i) == Str("añ世😀").utf8_at(i % 4));
+        }
+        Str piece = long_text.utf8_slice(101, 300);
+        REQUIRE(piece.utf8_size() == 199);
+        REQUIRE(piece.data() == long_text.data() + 25 * 10 + 1); // shares the characters
+        REQUIRE(piece.utf8_at(0) == "ñ");
+        REQUIRE(long_text.utf8_reverse().utf8_slice(0, 4) == "😀世ña");
+        Str copy = long_text;
+        REQUIRE(copy.utf8_at(-1) == "😀");
+        copy = std::move(long_text);
+        REQUIRE(copy.utf8_size() == 400);
+
+        // validation
+        REQUIRE(StrView("\xf0\x9f\x98\x80").is_utf8());
+        REQUIRE(!StrView("\xff").is_utf8());
+        REQUIRE(!StrView("\xc3").is_utf8());                 // truncated
+        REQUIRE(!StrView("\xc0\xaf").is_utf8());             // overlong
+        REQUIRE(!StrView("\xe0\x80\xaf").is_utf8());         // overlong
+        REQUIRE(!StrView("\xed\xa0\x80").is_utf8());         // surrogate
+        REQUIRE(!StrView("\xf4\x90\x80\x80").is_utf8());     // above U+10FFFF
+        REQUIRE(!(Str("a") * 100 + "\x80" + Str("b") * 100).is_utf8());
+        REQUIRE((Str("a") * 100 + "é" + Str("b") * 100).is_utf8());
+        REQUIRE_THROWS_MATCHES(Str("ab\xff").utf8_size(), std::runtime_error, Message("Error: Invalid UTF-8 string."));
+        REQUIRE_THROWS_MATCHES(Str("ab\xff").utf8_upper(), std::runtime_error, Message("Error: Invalid UTF-8 string."));
+
+        // case conversion of common scripts
+        REQUIRE(Str("ÀÉÎÕÜ Ÿ ĀĂĄ ŁŃ ŹŻŽ").utf8_lower() == "àéîõü ÿ āăą łń źżž");
+        REQUIRE(Str("àéîõü ÿ āăą łń źżž").utf8_upper() == "ÀÉÎÕÜ Ÿ ĀĂĄ ŁŃ ŹŻŽ");
+        REQUIRE(Str("straße").utf8_upper() == "STRASSE");
+        REQUIRE(Str("µ ı ſ").utf8_upper() == "Μ I S");
+        REQUIRE(Str("İ").utf8_lower() == "i̇");
+        REQUIRE(Str("ΆΈΉΊΌΎΏ ΑΒΓΔ").utf8_lower() == "άέήίόύώ αβγδ");
+        REQUIRE(Str("άέήίόύώ αβγδ").utf8_upper() == "ΆΈΉΊΌΎΏ ΑΒΓΔ");
+        REQUIRE(Str("ΟΔΟΣ ΣΑΣ Σ").utf8_lower() == "οδος σας σ"); // final sigma only at the end of a word
+        REQUIRE(Str("ς").utf8_upper() == "Σ");
+        REQUIRE(Str("ПРИВЕТ, ЁЖ").utf8_lower() == "привет, ёж");
+        REQUIRE(Str("привет, ёж").utf8_upper() == "ПРИВЕТ, ЁЖ");
+        REQUIRE(Str("世界 ÷×").utf8_upper() == "世界 ÷×");
+        REQUIRE(Str("Hello").utf8_upper() == "HELLO");
+        REQUIRE((Str("Ab") * 50 + "ÉÈ").utf8_lower() == Str("ab") * 50 + "éè");
     }
 
     SECTION("print")